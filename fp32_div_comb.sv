@@ -30,12 +30,19 @@
  * - All exception flags (invalid, divide-by-zero, overflow, underflow, inexact)
  * - Round-to-nearest-even (default) rounding mode
  * - Optimized for synthesis and timing closure
+ * - Selectable mantissa divider core (DIV_CORE): restoring, radix-4 SRT or
+ *   Newton-Raphson
  * 
  * @note Resource usage: Approximately 25-bit divider + normalization logic
  */
 
 // Combinational IEEE-754 Single-Precision Floating-Point Divider
-module fp32_div_comb (
+module fp32_div_comb #(
+    // Mantissa divider core: 0 = restoring (div_mant), 1 = radix-4 SRT
+    // (fp32_div_srt4.sv), 2 = Newton-Raphson (fp32_div_nr.sv). Results and
+    // flags are identical for every core.
+    parameter int DIV_CORE = 0
+) (
     // Input operands
     input  logic [31:0] a,                 // dividend (IEEE-754 FP32)
     input  logic [31:0] b,                 // divisor (IEEE-754 FP32)
@@ -116,27 +123,14 @@ module fp32_div_comb (
     end
   endfunction
 
-  // add function to count leading zeros in 50-bit quotient
-  function automatic [5:0] count_lz50(input logic [49:0] mant);
-    logic [5:0] i;
-    begin
-      count_lz50 = 6'd50;
-      // count leading zeros with 6-bit index wrap
-      for (i = 6'd49; i != 6'd63; i = i - 6'd1) begin
-        if (mant[i]) begin
-          // subtract with explicit 6-bit result
-          count_lz50 = 6'd49 - i;
-          break;
-        end
-      end
-    end
-  endfunction
-
   // normalize mantissas
   logic [23:0] norm_a, norm_b;
   logic signed [9:0] exp_unbias /*verilator public*/;
   // leading zero counts for subnormals
   logic [4:0] lz_a, lz_b;
+  // dividend pre-alignment: 1 when norm_a < norm_b, so norm_a is shifted left
+  // once and the quotient MSB lands in a fixed position
+  logic div_align;
   always_comb begin
     // default leading-zero counts for normalization
     lz_a   = (exp_a == 0) ? count_lz({1'b0, frac_a}) : 5'd0;
@@ -144,29 +138,37 @@ module fp32_div_comb (
     // normalize operands
     norm_a = (exp_a == 0) ? ({1'b0, frac_a} << lz_a) : {1'b1, frac_a};
     norm_b = (exp_b == 0) ? ({1'b0, frac_b} << lz_b) : {1'b1, frac_b};
+    div_align = (norm_a < norm_b);
     // compute unbiased exponent with subnormal adjustment
     if (is_zero_a || is_nan_a || is_nan_b || is_inf_b || is_zero_b) begin
       exp_unbias = 0;
     end else begin
       exp_unbias = $signed({2'b00, (exp_a != 0 ? exp_a : 8'd1)}) - $signed(
-          {2'b00, (exp_b != 0 ? exp_b : 8'd1)}) - $signed({5'd0, lz_a}) + $signed({5'd0, lz_b});
+          {2'b00, (exp_b != 0 ? exp_b : 8'd1)}) - $signed({5'd0, lz_a}) + $signed({5'd0, lz_b}) -
+          $signed({9'd0, div_align});
     end
   end
 
-  // mantissa division (restoring) + guard/sticky: 50-bit dividend to get 23+2 bits precision
-  function automatic [50:0] div_mant(input logic [49:0] num, input logic [23:0] den);
+  // mantissa division (restoring) + sticky: quotient of {num, 25'd0} / den
+  // The dividend is pre-aligned (num in [den, 2 * den)), so the quotient lies
+  // in [2^25, 2^26) and its MSB is always 1: no compare is needed for it and
+  // no leading-zero count or normalization shift after it. The remaining 25
+  // quotient bits (23-bit fraction + guard + round) come from the recurrence,
+  // plus the remainder-nonzero sticky bit.
+  function automatic [26:0] div_mant(input logic [24:0] num, input logic [23:0] den);
     integer i;
-    reg [49:0] q;
+    reg [25:0] q;
     reg [24:0] r;
     logic [24:0] den_ext;
     reg sticky;
     begin
-      r = 0;
       q = 0;
       sticky = 0;
       den_ext = {1'b0, den};
-      for (i = 49; i >= 0; i = i - 1) begin
-        r = {r[23:0], num[i]};
+      r = num - den_ext;
+      q[25] = 1;
+      for (i = 24; i >= 0; i = i - 1) begin
+        r = {r[23:0], 1'b0};  // r < den < 2^24 before the shift, so no bit is lost
         if (r >= den_ext) begin
           r = r - den_ext;
           q[i] = 1;
@@ -175,15 +177,15 @@ module fp32_div_comb (
         end
       end
       sticky   = |r;
-      div_mant = {sticky, q};  // sticky + 50-bit quotient
+      div_mant = {sticky, q};  // sticky + 26-bit quotient
     end
   endfunction
 
   // declare internal division signals
-  logic [49:0] opa_div;  // numerator shifted for precision (24 bits mantissa + 26 guard bits)
+  logic [24:0] opa_div;  // pre-aligned numerator mantissa (divided as {opa_div, 25'd0})
   logic [23:0] opb_div;  // denominator mantissa
-  logic [50:0] raw_div;  // sticky (bit50) + 50-bit quotient
-  logic [49:0] q_full;  // 50-bit quotient from divider
+  logic [26:0] div_q26;  // sticky (bit26) + 26-bit quotient from the divider core
+  logic [50:0] raw_div;  // sticky (bit50) + quotient zero-extended to 50 bits
   logic [49:0] q_norm;
   logic [23:0] q_div;  // hidden + 23-bit fraction
   logic guard_div;
@@ -191,7 +193,7 @@ module fp32_div_comb (
   logic sticky_div;
   // dynamic normalization intermediate signals
   logic sticky_raw_div;  // raw divider sticky bit
-  logic [5:0] lz_q;  // leading zero count of raw quotient
+  logic [5:0] lz_q;  // leading zeros of the equivalent unaligned 50-bit quotient (debug only)
   logic [49:0] shifted_q;  // normalized 50-bit quotient
   logic [24:0] q25;  // temp pre-rounded mantissa + guard bit
   logic [24:0] m;  // temporary mantissa for subnormal normalization
@@ -221,6 +223,27 @@ module fp32_div_comb (
   // dummy to suppress unused-signal warnings
   logic        dummy_unused;
 
+  // mantissa divider core (operands are don't-care for special cases)
+  assign opa_div = div_align ? {norm_a, 1'b0} : {1'b0, norm_a};
+  assign opb_div = norm_b;
+  generate
+    if (DIV_CORE == 1) begin : g_srt4
+      fp32_div_srt4 u_core (
+          .num     (opa_div),
+          .den     (opb_div),
+          .q_sticky(div_q26)
+      );
+    end else if (DIV_CORE == 2) begin : g_nr
+      fp32_div_nr u_core (
+          .num     (opa_div),
+          .den     (opb_div),
+          .q_sticky(div_q26)
+      );
+    end else begin : g_restoring
+      assign div_q26 = div_mant(opa_div, opb_div);
+    end
+  endgenerate
+
   // main comb logic
   always_comb begin
     // default for dummy, flags, and exp_sum to avoid latches
@@ -230,13 +253,10 @@ module fp32_div_comb (
     q25          = '0;
     // default internal signals
     raw_div          = '0;
-    opa_div          = '0;
-    opb_div          = '0;
     q_div            = '0;
     guard_div        = '0;
     round_div        = '0;
     sticky_div       = '0;
-    q_full           = '0;
     q_norm           = '0;
     sum_expr         = '0;
     mant_rnd_div     = '0;
@@ -316,15 +336,13 @@ module fp32_div_comb (
       // normalized division with post-div normalization and rounding
       // prepare operands for extended division
       // mantissa division (restoring) and dynamic normalization
-      // shift numerator to align for 23-bit mantissa + guard + round bits (total 25 extra bits)
-      opa_div          = {norm_a, 25'd0, 1'b0};
-      opb_div          = norm_b;
-      raw_div          = div_mant(opa_div, opb_div);
-      q_full           = raw_div[49:0];
+      // numerator is pre-aligned (exp_unbias already includes div_align) and
+      // extended by 25 zero bits for 23-bit mantissa + guard + round bits
+      raw_div          = {div_q26[26], 24'd0, div_q26[25:0]};
       sticky_raw_div   = raw_div[50];
-      lz_q             = count_lz50(q_full);
-      q_norm           = q_full << lz_q;
-      exp_sum          = exp_unbias + 10'sd150 - $signed({4'd0, lz_q});
+      lz_q             = 6'd23 + {5'd0, div_align};
+      q_norm           = {div_q26[25:0], 24'd0};  // MSB fixed at bit 49: no shifter
+      exp_sum          = exp_unbias + 10'sd127;
       // extract mantissa and rounding bits
       q_div            = {q_norm[49], q_norm[48:26]};
       guard_div        = q_norm[25];
@@ -0,0 +1,66 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2025 adachi6k
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+
+/**
+ * @file    fp32_div_comb_xN.sv
+ * @brief   N-lane wrapper of the combinational FP32 divider
+ * @author  adachi6k
+ * @date    2025
+ * 
+ * @description
+ * Instantiates N independent fp32_div_comb lanes behind wide packed ports so a
+ * single simulator evaluation computes N quotients. Lane i uses bits
+ * [32*i +: 32] of a, b and y, and bit i of each exception flag vector.
+ * 
+ * Used by the testbench lane build (make div_xN), which amortizes the fixed
+ * per-eval() cost of the Verilated model over N vectors.
+ */
+
+// N-lane Combinational IEEE-754 Single-Precision Floating-Point Divider
+module fp32_div_comb_xN #(
+    parameter int N = 16,                  // number of lanes
+    parameter int DIV_CORE = 0             // mantissa divider core of each lane (see fp32_div_comb)
+) (
+    // Input operands, lane i at [32*i +: 32]
+    input  logic [N*32-1:0] a,             // dividends (IEEE-754 FP32)
+    input  logic [N*32-1:0] b,             // divisors (IEEE-754 FP32)
+    
+    // IEEE-754 exception flags output, lane i at bit i
+    output logic [N-1:0]    exc_invalid,   // invalid operation
+    output logic [N-1:0]    exc_divzero,   // divide-by-zero
+    output logic [N-1:0]    exc_overflow,  // result magnitude too large
+    output logic [N-1:0]    exc_underflow, // result magnitude too small
+    output logic [N-1:0]    exc_inexact,   // result is not exactly representable
+    
+    // Result output, lane i at [32*i +: 32]
+    output logic [N*32-1:0] y              // quotients (IEEE-754 FP32)
+);
+
+  for (genvar i = 0; i < N; i++) begin : g_lane
+    fp32_div_comb #(.DIV_CORE(DIV_CORE)) u_div (
+        .a            (a[32*i +: 32]),
+        .b            (b[32*i +: 32]),
+        .exc_invalid  (exc_invalid[i]),
+        .exc_divzero  (exc_divzero[i]),
+        .exc_overflow (exc_overflow[i]),
+        .exc_underflow(exc_underflow[i]),
+        .exc_inexact  (exc_inexact[i]),
+        .y            (y[32*i +: 32])
+    );
+  end
+
+endmodule
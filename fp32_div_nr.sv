@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    fp32_div_nr.sv
+ * @brief   Newton-Raphson multiplicative mantissa divider core for fp32_div_comb (DIV_CORE = 2)
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Computes the same value as div_mant in fp32_div_comb.sv: the 26-bit
+ * quotient floor({num, 25'd0} / den) of the pre-aligned mantissas plus the
+ * remainder-nonzero sticky bit, with multipliers instead of a subtractive
+ * chain. With d = den / 2^24 in [1/2, 1):
+ *
+ * - r0: 10-bit reciprocal seed 1/d from a 128-entry table indexed by the 7
+ *   divisor bits below the leading one (relative error below 2^-8).
+ * - Two Newton-Raphson steps r' = r * (2 - d * r), each squaring the error.
+ *   A step never overshoots 1/d and every product is truncated, so the
+ *   32-bit reciprocal y ~ 2^55 / den is low by less than 2.4 units (checked
+ *   for every den).
+ * - q = (num * y) >> 30 is then floor(num * 2^25 / den) or one less. The
+ *   remainder {num, 25'd0} - q * den (26 low bits suffice, as it is below
+ *   2 * den) decides the final +1 and gives the sticky bit, so RNE rounding
+ *   in fp32_div_comb stays exact.
+ *
+ * Error terms are small, so the second step multiplies by 2 - d * r only
+ * through its low part eps = 1 - d * r (29 bits), and only the low bits of
+ * d * r and q * den are ever used.
+ *
+ * @note Results are only meaningful for den normalized and num in [den, 2 * den)
+ */
+
+// Newton-Raphson multiplicative mantissa divider core
+module fp32_div_nr (
+    input  logic [24:0] num,               // pre-aligned dividend mantissa, in [den, 2 * den)
+    input  logic [23:0] den,               // normalized divisor mantissa
+    output logic [26:0] q_sticky           // sticky (bit26) + 26-bit quotient
+);
+
+  // Reciprocal seeds: entry i = round(2^9 / d) at the midpoint of
+  // d in [(128 + i) / 256, (129 + i) / 256), evaluated at elaboration
+  logic [9:0] recip_rom [128];
+  for (genvar i = 0; i < 128; i++) begin : g_recip_rom
+    assign recip_rom[i] = 10'(((2 ** 19) / (257 + 2 * i) + 1) / 2);
+  end
+
+  logic [9:0]  r0;                         // seed, 1/d in units of 2^-9
+  logic [33:0] e1;                         // 2 - d * r0 in units of 2^-33
+  logic [43:0] p1;                         // r0 * e1
+  logic [20:0] r1;                         // first step, 1/d in units of 2^-20
+  logic [44:0] dr1;                        // d * r1 in units of 2^-44
+  logic [28:0] eps;                        // 1 - d * r1 in units of 2^-44
+  logic [49:0] p2;                         // r1 * eps
+  logic [31:0] recip;                      // second step, 2^55 / den (1/d in units of 2^-31)
+  logic [56:0] pq;                         // num * recip
+  logic [25:0] q_est;                      // quotient estimate, exact or one low
+  logic [49:0] q_den;                      // q_est * den
+  logic [25:0] rem;                        // {num, 25'd0} - q_est * den, below 2 * den
+  logic        q_low;                      // estimate one low: remainder >= den
+  logic [25:0] rem_final;
+
+  always_comb begin
+    // seed and first step: r1 = r0 * (2 - d * r0)
+    r0    = recip_rom[den[22:16]];
+    e1    = 34'd0 - ({10'd0, den} * {24'd0, r0});  // 2^34 - den * r0, which is in (0, 2^34)
+    p1    = {34'd0, r0} * {10'd0, e1};
+    r1    = p1[42:22];
+    // second step: recip = r1 + r1 * (1 - d * r1); eps < 2^29 for every den
+    dr1   = {21'd0, den} * {24'd0, r1};
+    eps   = 29'd0 - dr1[28:0];
+    p2    = {29'd0, r1} * {21'd0, eps};
+    recip = {r1, 11'd0} + {15'd0, p2[49:33]};
+    // quotient estimate and remainder-based correction
+    pq    = {32'd0, num} * {25'd0, recip};
+    q_est = pq[55:30];
+    q_den = {24'd0, q_est} * {26'd0, den};
+    rem   = {num[0], 25'd0} - q_den[25:0];
+    q_low = rem >= {2'b00, den};
+    rem_final = q_low ? rem - {2'b00, den} : rem;
+    q_sticky  = {|rem_final, q_low ? q_est + 26'd1 : q_est};
+  end
+
+endmodule
@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    fp32_div_srt4.sv
+ * @brief   Radix-4 SRT mantissa divider core for fp32_div_comb (DIV_CORE = 1)
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Computes the same value as div_mant in fp32_div_comb.sv: the 26-bit
+ * quotient floor({num, 25'd0} / den) of the pre-aligned mantissas plus the
+ * remainder-nonzero sticky bit, so fp32_div_comb results and flags do not
+ * depend on the core.
+ *
+ * Recurrence (minimally redundant digit set {-2..2}, bound rho = 2/3):
+ *   W[0] = num,  W[j+1] = 4 * W[j] - q[j+1] * 4 * den,  |W[j]| <= (2/3) * 4 * den
+ * After 14 steps num * 2^26 / den = Q + W / (4 * den), a 27-bit quotient
+ * whose LSB is folded into the sticky bit.
+ *
+ * - The partial remainder is kept in carry-save form (ws + wc, 29-bit two's
+ *   complement), so each step is one 3:2 compressor row instead of a 25-bit
+ *   carry-propagate compare and subtract.
+ * - Each digit is selected from a 7-bit estimate of 4 * W (sign, 2 integer
+ *   and 4 fraction bits of both words, added) and the 3 divisor bits below
+ *   the leading one, against the threshold table srt4_threshold().
+ * - The quotient is converted on the fly: Q and QM = Q - 1 are both kept, so
+ *   negative digits need no borrow chain and the final correction for a
+ *   negative remainder is a select.
+ *
+ * Only the last step has a carry-propagate adder: the remainder sign and
+ * zero test for the quotient correction and the sticky bit.
+ *
+ * @note Results are only meaningful for den normalized and num in [den, 2 * den)
+ */
+
+// Radix-4 SRT mantissa divider core
+module fp32_div_srt4 (
+    input  logic [24:0] num,               // pre-aligned dividend mantissa, in [den, 2 * den)
+    input  logic [23:0] den,               // normalized divisor mantissa
+    output logic [26:0] q_sticky           // sticky (bit26) + 26-bit quotient
+);
+
+  localparam int STEPS = 14;               // radix-4 digits: 28 quotient bits >= 27 needed
+
+  // Digit-selection thresholds m_k(i) in units of 2^-4 for the divisor
+  // interval i = den[22:20], i.e. den / 2^24 in [1/2 + i/16, 1/2 + (i+1)/16):
+  // digit k is chosen when the estimate is at least m_k and below m_(k+1).
+  // Each entry keeps the next remainder within the bound for every 4 * W and
+  // divisor the estimate and interval can stand for (estimate error < 2^-3).
+  function automatic logic signed [6:0] srt4_threshold(input logic [2:0] i, input int k);
+    logic signed [6:0] m2, m1, m0, mm1;
+    begin
+      case (i)
+        3'd0: begin m2 = 7'sd12; m1 = 7'sd4; m0 = -7'sd4; mm1 = -7'sd13; end
+        3'd1: begin m2 = 7'sd14; m1 = 7'sd5; m0 = -7'sd5; mm1 = -7'sd15; end
+        3'd2: begin m2 = 7'sd15; m1 = 7'sd5; m0 = -7'sd5; mm1 = -7'sd16; end
+        3'd3: begin m2 = 7'sd16; m1 = 7'sd6; m0 = -7'sd5; mm1 = -7'sd18; end
+        3'd4: begin m2 = 7'sd18; m1 = 7'sd7; m0 = -7'sd6; mm1 = -7'sd20; end
+        3'd5: begin m2 = 7'sd19; m1 = 7'sd7; m0 = -7'sd6; mm1 = -7'sd21; end
+        3'd6: begin m2 = 7'sd20; m1 = 7'sd8; m0 = -7'sd6; mm1 = -7'sd23; end
+        default: begin m2 = 7'sd22; m1 = 7'sd9; m0 = -7'sd7; mm1 = -7'sd25; end
+      endcase
+      case (k)
+        2:       srt4_threshold = m2;
+        1:       srt4_threshold = m1;
+        0:       srt4_threshold = m0;
+        default: srt4_threshold = mm1;
+      endcase
+    end
+  endfunction
+
+  // recurrence state
+  logic [28:0] ws, wc;                     // carry-save partial remainder
+  logic [28:0] ws4, wc4;                   // both words shifted left by 2 (4 * W)
+  logic [28:0] qd;                         // selected multiple of 4 * den, inverted for q > 0
+  logic signed [6:0] est;                  // estimate of 4 * W in units of 2^-4
+  logic signed [2:0] q;                    // quotient digit
+  logic [27:0] q_acc, qm_acc;              // on-the-fly quotient Q and Q - 1
+  logic [27:0] q_next, qm_next;
+  logic [28:0] w_final;                    // assimilated final remainder
+  logic [27:0] q_final;                    // quotient after the remainder sign correction
+
+  always_comb begin
+    ws     = {4'd0, num};
+    wc     = '0;
+    ws4    = '0;
+    wc4    = '0;
+    qd     = '0;
+    est    = '0;
+    q      = '0;
+    q_acc  = '0;
+    qm_acc = '0;
+    q_next = '0;
+    qm_next = '0;
+    for (int j = 0; j < STEPS; j++) begin
+      ws4 = {ws[26:0], 2'b00};
+      wc4 = {wc[26:0], 2'b00};
+      // digit selection from the truncated carry-save estimate
+      est = $signed(ws4[28:22] + wc4[28:22]);
+      if      (est >= srt4_threshold(den[22:20],  2)) q =  3'sd2;
+      else if (est >= srt4_threshold(den[22:20],  1)) q =  3'sd1;
+      else if (est >= srt4_threshold(den[22:20],  0)) q =  3'sd0;
+      else if (est >= srt4_threshold(den[22:20], -1)) q = -3'sd1;
+      else                                            q = -3'sd2;
+      // W = 4 * W - q * 4 * den: subtracting adds the inverted multiple + 1
+      case (q)
+        3'sd2:   qd = ~{2'b00, den, 3'b000};
+        3'sd1:   qd = ~{3'b000, den, 2'b00};
+        -3'sd1:  qd =  {3'b000, den, 2'b00};
+        -3'sd2:  qd =  {2'b00, den, 3'b000};
+        default: qd = '0;
+      endcase
+      // 3:2 compressor row; the +1 of the inversion enters the free carry LSB
+      ws = ws4 ^ wc4 ^ qd;
+      wc = {(ws4[27:0] & wc4[27:0]) | (ws4[27:0] & qd[27:0]) | (wc4[27:0] & qd[27:0]), q > 3'sd0};
+      // on-the-fly conversion, digits taken mod 4:
+      //   Q  <- (q < 0 ? QM : Q) * 4 + q,  QM <- (q > 0 ? Q : QM) * 4 + q - 1
+      q_next  = {(q < 3'sd0) ? qm_acc[25:0] : q_acc[25:0], q[1:0]};
+      qm_next = {(q > 3'sd0) ? q_acc[25:0] : qm_acc[25:0], q[1:0] + 2'd3};
+      q_acc   = q_next;
+      qm_acc  = qm_next;
+    end
+    // a negative remainder means the digits overshot by one unit
+    w_final  = ws + wc;
+    q_final  = w_final[28] ? qm_acc : q_acc;
+    q_sticky = {q_final[0] | (|w_final), q_final[26:1]};
+  end
+
+endmodule
@@ -0,0 +1,200 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    fp32_host_ref.h
+ * @brief   Host-FPU (SSE) batch reference for FP32 division and square root
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Computes reference results four lanes at a time with divps/sqrtps under
+ * round-to-nearest-even with FTZ/DAZ cleared, which yields the IEEE-754
+ * result for every finite, non-tiny case. Flags are rebuilt per lane:
+ * - MXCSR status is read once per group of four division lanes; a group
+ *   that raised nothing beyond inexact takes the fast path
+ * - inexact is decided per lane exactly in double precision (q*b == a,
+ *   r*r == a; the products of two floats are exact in a double)
+ * - infinities from overflow/divide-by-zero are classified per lane
+ *
+ * Lanes the host cannot answer in RISC-V/SoftFloat terms go to a caller
+ * supplied fallback (SoftFloat): NaN inputs or results (x86 default NaN is
+ * 0xffc00000, RISC-V canonical NaN is 0x7fc00000) and results at or below the
+ * smallest normal, where x86 detects tininess after rounding.
+ *
+ * Without SSE2 every lane uses the fallback.
+ */
+
+#ifndef FP32_HOST_REF_H
+#define FP32_HOST_REF_H
+
+#include <cstddef>
+#include <cstdint>
+#include "fp32_ref_model.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace fp32_host {
+
+#if defined(__SSE2__)
+
+// MXCSR status bits
+static constexpr uint32_t MXCSR_IE = 0x0001;  // invalid
+static constexpr uint32_t MXCSR_ZE = 0x0004;  // divide-by-zero
+static constexpr uint32_t MXCSR_OE = 0x0008;  // overflow
+static constexpr uint32_t MXCSR_UE = 0x0010;  // underflow
+// All exceptions masked, round-to-nearest, FTZ and DAZ cleared
+static constexpr uint32_t MXCSR_RNE_IEEE = 0x1f80;
+
+/**
+ * @brief Scoped MXCSR setup: RNE, FTZ/DAZ off, exceptions masked
+ */
+class MxcsrScope {
+public:
+  MxcsrScope() : saved_(_mm_getcsr()) { _mm_setcsr(MXCSR_RNE_IEEE); }
+  ~MxcsrScope() { _mm_setcsr(saved_); }
+private:
+  uint32_t saved_;
+};
+
+/**
+ * @brief Per-lane inexact mask: 4-bit mask of lanes where x*y != z in double precision
+ */
+inline int inexact_mask(__m128 x, __m128 y, __m128 z) {
+  __m128d lo = _mm_cmpneq_pd(_mm_mul_pd(_mm_cvtps_pd(x), _mm_cvtps_pd(y)), _mm_cvtps_pd(z));
+  __m128d hi = _mm_cmpneq_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)),
+                                        _mm_cvtps_pd(_mm_movehl_ps(y, y))),
+                             _mm_cvtps_pd(_mm_movehl_ps(z, z)));
+  return _mm_movemask_pd(lo) | (_mm_movemask_pd(hi) << 2);
+}
+
+/**
+ * @brief 4-bit mask of lanes whose magnitude is <= min normal or NaN (host result not usable)
+ */
+inline int hard_lane_mask(__m128i bits) {
+  __m128i mag   = _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff));
+  __m128i tiny  = _mm_cmplt_epi32(mag, _mm_set1_epi32(0x00800001));
+  __m128i nan   = _mm_cmpgt_epi32(mag, _mm_set1_epi32(0x7f800000));
+  return _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(tiny, nan)));
+}
+
+#endif  // __SSE2__
+
+/**
+ * @brief Reference a[i] / b[i] for n lanes; fallback(a, b) handles the hard lanes
+ */
+template <typename Fallback>
+inline void div_batch(const uint32_t* a, const uint32_t* b, fp32_ref::Result* out, size_t n,
+                      Fallback fallback) {
+#if defined(__SSE2__)
+  MxcsrScope scope;
+  for (size_t i = 0; i < n; i += 4) {
+    // Gather up to four lanes (tail lanes divide 1/1)
+    alignas(16) uint32_t la[4] = {0x3f800000, 0x3f800000, 0x3f800000, 0x3f800000};
+    alignas(16) uint32_t lb[4] = {0x3f800000, 0x3f800000, 0x3f800000, 0x3f800000};
+    alignas(16) uint32_t lq[4];
+    size_t lanes = (n - i < 4) ? n - i : 4;
+    for (size_t l = 0; l < lanes; ++l) {
+      la[l] = a[i + l];
+      lb[l] = b[i + l];
+    }
+    __m128 va = _mm_load_ps(reinterpret_cast<const float*>(la));
+    __m128 vb = _mm_load_ps(reinterpret_cast<const float*>(lb));
+
+    // Divide with clean status; the empty asm statements pin the division
+    // between the MXCSR write and read
+    _mm_setcsr(MXCSR_RNE_IEEE);
+    __asm__ volatile("" : "+x"(va), "+x"(vb));
+    __m128 vq = _mm_div_ps(va, vb);
+    __asm__ volatile("" : "+x"(vq));
+    uint32_t status = _mm_getcsr();
+    _mm_store_ps(reinterpret_cast<float*>(lq), vq);
+
+    // NaN inputs always produce NaN quotients, so the quotient alone tells
+    // which lanes are hard; infinite quotients need per-lane classification
+    __m128i qbits = _mm_castps_si128(vq);
+    int inexact = inexact_mask(vq, vb, va);
+    int hard = hard_lane_mask(qbits);
+    int inf = _mm_movemask_ps(_mm_castsi128_ps(
+        _mm_cmpeq_epi32(_mm_and_si128(qbits, _mm_set1_epi32(0x7fffffff)), _mm_set1_epi32(0x7f800000))));
+    bool clean = (status & (MXCSR_IE | MXCSR_ZE | MXCSR_OE | MXCSR_UE)) == 0 && (hard | inf) == 0;
+
+    if (clean) {
+      for (size_t l = 0; l < lanes; ++l) {
+        out[i + l] = {lq[l], (inexact >> l) & 1 ? fp32_ref::FLAG_INEXACT : uint8_t(0)};
+      }
+      continue;
+    }
+    for (size_t l = 0; l < lanes; ++l) {
+      if (!(((hard | inf) >> l) & 1)) {
+        out[i + l] = {lq[l], (inexact >> l) & 1 ? fp32_ref::FLAG_INEXACT : uint8_t(0)};
+      } else if ((hard >> l) & 1) {
+        out[i + l] = fallback(la[l], lb[l]);
+      } else {
+        // Infinite quotient: exact (inf / x), divide-by-zero, or overflow
+        uint32_t mag_a = la[l] & 0x7fffffff, mag_b = lb[l] & 0x7fffffff;
+        uint8_t flags = (mag_a == 0x7f800000) ? uint8_t(0)
+                      : (mag_b == 0)          ? fp32_ref::FLAG_DIVZERO
+                      : uint8_t(fp32_ref::FLAG_OVERFLOW | fp32_ref::FLAG_INEXACT);
+        out[i + l] = {lq[l], flags};
+      }
+    }
+  }
+#else
+  for (size_t i = 0; i < n; ++i) out[i] = fallback(a[i], b[i]);
+#endif
+}
+
+/**
+ * @brief Reference sqrt(a[i]) for n lanes; fallback(a) handles the hard lanes
+ */
+template <typename Fallback>
+inline void sqrt_batch(const uint32_t* a, fp32_ref::Result* out, size_t n, Fallback fallback) {
+#if defined(__SSE2__)
+  MxcsrScope scope;
+  for (size_t i = 0; i < n; i += 4) {
+    alignas(16) uint32_t la[4] = {0x3f800000, 0x3f800000, 0x3f800000, 0x3f800000};
+    alignas(16) uint32_t lr[4];
+    size_t lanes = (n - i < 4) ? n - i : 4;
+    for (size_t l = 0; l < lanes; ++l) la[l] = a[i + l];
+    __m128 va = _mm_load_ps(reinterpret_cast<const float*>(la));
+
+    // sqrt cannot overflow, underflow or divide by zero, so no MXCSR status
+    // is needed: only NaN results (NaN or negative inputs) are hard lanes
+    __m128 vr = _mm_sqrt_ps(va);
+    _mm_store_ps(reinterpret_cast<float*>(lr), vr);
+    int inexact = inexact_mask(vr, vr, va);
+    int hard = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(
+        _mm_and_si128(_mm_castps_si128(vr), _mm_set1_epi32(0x7fffffff)), _mm_set1_epi32(0x7f800000))));
+
+    for (size_t l = 0; l < lanes; ++l) {
+      if ((hard >> l) & 1) {
+        out[i + l] = fallback(la[l]);
+      } else {
+        out[i + l] = {lr[l], (inexact >> l) & 1 ? fp32_ref::FLAG_INEXACT : uint8_t(0)};
+      }
+    }
+  }
+#else
+  for (size_t i = 0; i < n; ++i) out[i] = fallback(a[i]);
+#endif
+}
+
+}  // namespace fp32_host
+
+#endif  // FP32_HOST_REF_H
@@ -0,0 +1,215 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    fp32_ref_model.h
+ * @brief   Bit-exact native C++ model of fp32_div_comb and fp32_sqrt_comb
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Header-only model of the RTL datapaths using 64-bit integer arithmetic:
+ * - div(): unpack/normalize with dividend pre-alignment, restoring div_mant
+ *   (as one integer division with a fixed-position 26-bit quotient), RNE
+ *   rounding and the subnormal path of fp32_div_comb.sv, including its flag
+ *   post-processing
+ * - sqrt(): unpack/normalize and sqrt_pair (floor root of the 50-bit operand
+ *   plus remainder sticky) with RNE rounding of fp32_sqrt_comb.sv
+ *
+ * Results follow the RISC-V conventions of the RTL (canonical NaN 0x7fc00000).
+ * Flags use the SoftFloat bit layout, which is also how the testbenches pack
+ * the DUT exc_* outputs: invalid<<4 | divzero<<3 | overflow<<2 | underflow<<1 | inexact.
+ *
+ * The model is a fast oracle for the testbench hot loops; it is validated
+ * against SoftFloat at startup before being trusted.
+ */
+
+#ifndef FP32_REF_MODEL_H
+#define FP32_REF_MODEL_H
+
+#include <cmath>
+#include <cstdint>
+
+namespace fp32_ref {
+
+// Exception flag bits (SoftFloat softfloat_flag_* layout)
+static constexpr uint8_t FLAG_INEXACT   = 0x01;
+static constexpr uint8_t FLAG_UNDERFLOW = 0x02;
+static constexpr uint8_t FLAG_OVERFLOW  = 0x04;
+static constexpr uint8_t FLAG_DIVZERO   = 0x08;
+static constexpr uint8_t FLAG_INVALID   = 0x10;
+
+static constexpr uint32_t CANONICAL_NAN = 0x7fc00000;
+
+/**
+ * @brief Result bits and exception flags of one operation
+ */
+struct Result {
+  uint32_t y;
+  uint8_t  flags;
+};
+
+/**
+ * @brief count_lz over a 24-bit mantissa (24 for zero)
+ */
+inline int count_lz24(uint32_t mant) {
+  return mant ? __builtin_clz(mant) - 8 : 24;
+}
+
+/**
+ * @brief Model of fp32_div_comb: y = a / b with IEEE-754 RNE and RTL flag rules
+ */
+inline Result div(uint32_t a, uint32_t b) {
+  const uint32_t sign_z = (a ^ b) & 0x80000000u;
+  const uint32_t exp_a  = (a >> 23) & 0xff, exp_b = (b >> 23) & 0xff;
+  const uint32_t frac_a = a & 0x7fffff,     frac_b = b & 0x7fffff;
+  const bool zero_a = exp_a == 0 && frac_a == 0,    zero_b = exp_b == 0 && frac_b == 0;
+  const bool inf_a  = exp_a == 0xff && frac_a == 0, inf_b  = exp_b == 0xff && frac_b == 0;
+  const bool nan_a  = exp_a == 0xff && frac_a != 0, nan_b  = exp_b == 0xff && frac_b != 0;
+
+  // Special cases, in RTL priority order
+  if (nan_a || nan_b) {
+    bool snan = (nan_a && !(frac_a & 0x400000)) || (nan_b && !(frac_b & 0x400000));
+    return {CANONICAL_NAN, snan ? FLAG_INVALID : uint8_t(0)};
+  }
+  if (inf_a && inf_b)   return {CANONICAL_NAN, FLAG_INVALID};
+  if (inf_a)            return {sign_z | 0x7f800000u, 0};
+  if (zero_a && zero_b) return {CANONICAL_NAN, FLAG_INVALID};
+  if (inf_b || zero_a)  return {sign_z, 0};
+  if (zero_b)           return {sign_z | 0x7f800000u, FLAG_DIVZERO};
+
+  // Normalize operands and compute the unbiased exponent difference
+  const int lz_a = exp_a == 0 ? count_lz24(frac_a) : 0;
+  const int lz_b = exp_b == 0 ? count_lz24(frac_b) : 0;
+  const uint64_t norm_a = exp_a == 0 ? (uint64_t(frac_a) << lz_a) : (0x800000u | frac_a);
+  const uint64_t norm_b = exp_b == 0 ? (uint64_t(frac_b) << lz_b) : (0x800000u | frac_b);
+  const int div_align  = norm_a < norm_b ? 1 : 0;
+  const int exp_unbias = int(exp_a ? exp_a : 1) - int(exp_b ? exp_b : 1) - lz_a + lz_b - div_align;
+
+  // div_mant: restoring division of the pre-aligned {opa_div, 25'd0} by norm_b,
+  // a 26-bit quotient with its MSB at bit 25, placed at the top of q_norm
+  const uint64_t opa_div  = norm_a << (25 + div_align);
+  const uint64_t q_norm   = (opa_div / norm_b) << 24;
+  const bool sticky_raw   = (opa_div % norm_b) != 0;
+  const int exp_sum       = exp_unbias + 127;
+
+  // Main-path rounding bits
+  const uint32_t q_div  = uint32_t(q_norm >> 26);
+  const bool guard_div  = (q_norm >> 25) & 1;
+  const bool round_div  = (q_norm >> 24) & 1;
+  const bool sticky_div = sticky_raw || (q_norm & 0xffffff) != 0;
+  const bool round_up   = guard_div && (round_div || sticky_div || (q_div & 1));
+  const uint32_t sum    = q_div + (round_up ? 1 : 0);
+  const uint32_t norm1  = sum >> 24;
+  const uint32_t mant_rnd = norm1 ? (sum >> 1) : (sum & 0xffffff);
+
+  uint32_t y;
+  uint8_t flags = 0;
+  bool guard_s = false, round_s = false, sticky_s = false;
+  if (exp_sum + int(norm1) > 254) {
+    // overflow -> infinity
+    flags = FLAG_OVERFLOW | FLAG_INEXACT;
+    y = sign_z | 0x7f800000u;
+  } else if (exp_sum <= -24) {
+    // deep underflow -> zero
+    flags = FLAG_UNDERFLOW | FLAG_INEXACT;
+    y = sign_z;
+  } else if (exp_sum <= 0) {
+    // gradual underflow: shift {q_norm, sticky} right by S = 1 - exp_sum
+    const int S = 1 - exp_sum;
+    const uint64_t frac_s = ((q_norm << 1) | (sticky_raw ? 1 : 0)) >> S;
+    const uint32_t mant_res = uint32_t(frac_s >> 27) & 0x7fffff;
+    guard_s  = (frac_s >> 26) & 1;
+    round_s  = (frac_s >> 25) & 1;
+    sticky_s = (frac_s & 0x1ffffff) != 0 || sticky_raw;
+    const bool round_up_s = guard_s && (round_s || sticky_s || (mant_res & 1));
+    const uint32_t mant_rounded = mant_res + (round_up_s ? 1 : 0);
+    if (guard_s || round_s || sticky_s) flags = FLAG_UNDERFLOW | FLAG_INEXACT;
+    y = (mant_rounded & 0x800000) ? (sign_z | 0x00800000u) : (sign_z | (mant_rounded & 0x7fffff));
+  } else {
+    const uint32_t exp_z = uint32_t(exp_sum + int(norm1)) & 0xff;
+    if (guard_div || round_div || sticky_div) flags |= FLAG_INEXACT;
+    if (exp_z == 0) flags |= FLAG_UNDERFLOW;
+    y = sign_z | (exp_z << 23) | (mant_rnd & 0x7fffff);
+  }
+
+  // Post-process: subnormal or zero results with lost bits raise underflow/inexact
+  if (!(flags & FLAG_OVERFLOW) && ((y >> 23) & 0xff) == 0 &&
+      (guard_div || round_div || sticky_div || guard_s || round_s || sticky_s)) {
+    flags |= FLAG_UNDERFLOW | FLAG_INEXACT;
+  }
+  return {y, flags};
+}
+
+/**
+ * @brief floor(sqrt(op)) for op < 2^50, as produced by sqrt_pair
+ */
+inline uint64_t isqrt50(uint64_t op) {
+  // op is exact in a double; correct the estimate to the integer floor root
+  uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(op)));
+  while (root * root > op) --root;
+  while ((root + 1) * (root + 1) <= op) ++root;
+  return root;
+}
+
+/**
+ * @brief Model of fp32_sqrt_comb: y = sqrt(a) with IEEE-754 RNE and RTL flag rules
+ */
+inline Result sqrt(uint32_t a) {
+  const bool sign     = a >> 31;
+  const uint32_t exp  = (a >> 23) & 0xff;
+  const uint32_t frac = a & 0x7fffff;
+  const bool is_zero  = exp == 0 && frac == 0;
+  const bool is_inf   = exp == 0xff && frac == 0;
+  const bool is_nan   = exp == 0xff && frac != 0;
+
+  if (is_nan)             return {CANONICAL_NAN, (frac & 0x400000) ? uint8_t(0) : FLAG_INVALID};
+  if (sign && !is_zero)   return {CANONICAL_NAN, FLAG_INVALID};
+  if (is_inf)             return {0x7f800000u, 0};
+  if (is_zero)            return {a, 0};
+
+  // Normalize and halve the exponent
+  const bool subnormal    = exp == 0;
+  const int lz            = subnormal ? count_lz24(frac) : 0;
+  const uint64_t norm     = subnormal ? ((uint64_t(frac) << lz) & 0xffffff) : (0x800000u | frac);
+  const int exp_unbias_s  = subnormal ? -126 - lz : int(exp) - 127;
+  const int rebias        = (exp_unbias_s >> 1) + 127;  // arithmetic shift, as >>> in RTL
+
+  // sqrt_pair on {sqrt_op, 25'd0}; odd exponents pre-shift the mantissa
+  const uint64_t sqrt_op  = (exp_unbias_s & 1) ? (norm << 1) : norm;
+  const uint64_t op50     = sqrt_op << 25;
+  const uint64_t raw_root = isqrt50(op50);
+  const bool sticky_bit   = raw_root * raw_root != op50;
+  const bool guard_bit    = raw_root & 1;
+
+  // Round to nearest even with carry into the exponent
+  const uint32_t rounded_ext = uint32_t(raw_root >> 1) +
+                               ((guard_bit && (((raw_root >> 1) & 1) || sticky_bit)) ? 1 : 0);
+  uint32_t root_rounded, out_exp;
+  if (rounded_ext & 0x1000000) {
+    root_rounded = rounded_ext >> 1;
+    out_exp      = uint32_t(rebias + 1) & 0xff;
+  } else {
+    root_rounded = rounded_ext;
+    out_exp      = uint32_t(rebias) & 0xff;
+  }
+  return {(out_exp << 23) | (root_rounded & 0x7fffff),
+          (guard_bit || sticky_bit) ? FLAG_INEXACT : uint8_t(0)};
+}
+
+}  // namespace fp32_ref
+
+#endif  // FP32_REF_MODEL_H
@@ -30,12 +30,19 @@
  * - Exception flags (invalid, overflow, underflow, inexact)
  * - Round-to-nearest-even (default) rounding mode
  * - Optimized for synthesis and timing closure
+ * - Selectable mantissa square root core (SQRT_CORE): restoring pair-bit or
+ *   radix-4 SRT
  * 
  * @note Resource usage: Non-restoring square root algorithm implementation
  */
 
 // Combinational IEEE-754 Single-Precision Floating-Point Square Root
-module fp32_sqrt_comb (
+module fp32_sqrt_comb #(
+    // Mantissa square root core: 0 = restoring pair-bit (sqrt_pair),
+    // 1 = radix-4 SRT (fp32_sqrt_srt4.sv). Results and flags are identical
+    // for every core.
+    parameter int SQRT_CORE = 0
+) (
     // Input operand
     input  logic [31:0] a,                 // input (IEEE-754 FP32)
     
@@ -61,6 +68,18 @@ module fp32_sqrt_comb (
   // Special cases
   logic is_zero, is_inf, is_nan, is_neg;
 
+  // Debug signals for coverage collection and failure analysis
+  // (accessible from testbench via Verilator public_flat)
+  logic        dbg_special_path   /*verilator public_flat*/;  // NaN, negative, inf or zero input
+  logic        dbg_subnormal_in   /*verilator public_flat*/;  // subnormal input (normalized by count_lz)
+  logic        dbg_exp_odd        /*verilator public_flat*/;  // odd unbiased exponent (operand pre-shifted)
+  logic [ 9:0] dbg_exp_unbias     /*verilator public_flat*/;  // signed unbiased input exponent
+  logic [24:0] dbg_raw_root       /*verilator public_flat*/;  // root before rounding (LSB = guard)
+  logic        dbg_guard_bit      /*verilator public_flat*/;  // guard bit for rounding
+  logic        dbg_sticky_bit     /*verilator public_flat*/;  // sticky bit (non-zero remainder)
+  logic        dbg_round_up       /*verilator public_flat*/;  // round up decision
+  logic        dbg_round_carry    /*verilator public_flat*/;  // rounding carried into the exponent
+
   assign sign = a[31];
   assign exp = a[30:23];
   assign frac = a[22:0];
@@ -118,12 +137,14 @@ module fp32_sqrt_comb (
     sqrt_exp = rebias[7:0];
   end
 
-  // Calculate sqrt mantissa using radix-4 (pair-bit) algorithm (25bit result + guard)
+  // Calculate sqrt mantissa with the SQRT_CORE core (25bit result + guard)
   logic [24:0] sqrt_op;
   // extended operand (2*25 bits)
   logic [49:0] op50;
   // raw result plus sticky bit for correct rounding
   logic [25:0] raw_sticky;
+  // raw_root[24:1] + 1, the rounded-up root (bit24 = carry)
+  logic [24:0] root_inc;
   logic [24:0] raw_root;
   logic guard_bit, sticky_bit;
   logic [23:0] root_rounded;
@@ -158,6 +179,22 @@ module fp32_sqrt_comb (
     end
   endfunction
 
+  // mantissa square root core (operand is don't-care for special cases)
+  assign sqrt_op = exp_unbias_s[0] ? {norm_mant, 1'b0} : {1'b0, norm_mant};
+  assign op50    = {sqrt_op, 25'b0};
+  generate
+    if (SQRT_CORE == 1) begin : g_srt4
+      fp32_sqrt_srt4 u_core (
+          .op         (sqrt_op),
+          .root_sticky(raw_sticky),
+          .root_inc   (root_inc)
+      );
+    end else begin : g_restoring
+      assign raw_sticky = sqrt_pair(op50);
+      assign root_inc   = {1'b0, raw_sticky[24:1]} + 25'd1;
+    end
+  endgenerate
+
   always_comb begin
     // defaults to avoid latches
     exc_invalid          = 1'b0;
@@ -169,9 +206,6 @@ module fp32_sqrt_comb (
     result               = '0;
     unused_sqrt_frac_msb = 1'b0;
     unused_rebias_hi     = 2'b0;
-    sqrt_op              = '0;
-    op50                 = '0;
-    raw_sticky           = '0;
     raw_root             = '0;
     guard_bit            = '0;
     sticky_bit           = '0;
@@ -179,6 +213,16 @@ module fp32_sqrt_comb (
     sqrt_frac            = '0;
     out_exp              = '0;
     rounded_ext          = '0;
+    // Debug signal defaults (special path unless the normal case runs)
+    dbg_special_path     = 1'b1;
+    dbg_subnormal_in     = '0;
+    dbg_exp_odd          = '0;
+    dbg_exp_unbias       = '0;
+    dbg_raw_root         = '0;
+    dbg_guard_bit        = '0;
+    dbg_sticky_bit       = '0;
+    dbg_round_up         = '0;
+    dbg_round_carry      = '0;
     if (is_nan) begin
       // RISC-V: signaling NaN raises invalid, always return canonical NaN
       exc_invalid = (frac[22] == 1'b0) ? 1'b1 : 1'b0;
@@ -195,20 +239,16 @@ module fp32_sqrt_comb (
       result = a;
     end else begin
       // Normal case
-      // Guard-bit rounding path: select even/odd exponent shift
-      // select even/odd exponent shift based on signed unbiased exponent
-      sqrt_op     = exp_unbias_s[0] ? {norm_mant, 1'b0} : {1'b0, norm_mant};
-      // build 50-bit operand: sqrt_op << 25
-      op50        = {sqrt_op, 25'b0};
-      // compute pair-bit sqrt
-      raw_sticky  = sqrt_pair(op50);
+      // Guard-bit rounding path: the core root of sqrt_op << 25, where
+      // sqrt_op is pre-shifted by the even/odd signed unbiased exponent
       raw_root    = raw_sticky[24:0];
       guard_bit   = raw_root[0];
       sticky_bit  = raw_sticky[25];
       // inexact if any rounding bits set
       exc_inexact = guard_bit | sticky_bit;
-      // round-to-nearest-even with overflow detection
-      rounded_ext = {1'b0, raw_root[24:1]} + {24'b0, guard_bit & (raw_root[1] | sticky_bit)};
+      // round-to-nearest-even with overflow detection; the core supplies the
+      // incremented root, so rounding is a select
+      rounded_ext = (guard_bit & (raw_root[1] | sticky_bit)) ? root_inc : {1'b0, raw_root[24:1]};
       if (rounded_ext[24]) begin
         // rounding overflow, adjust mantissa and exponent
         root_rounded = rounded_ext[24:1];
@@ -218,6 +258,17 @@ module fp32_sqrt_comb (
         out_exp      = sqrt_exp[7:0];
       end
       sqrt_frac = root_rounded;
+
+      // Debug signal assignments for the normal path
+      dbg_special_path = 1'b0;
+      dbg_subnormal_in = (exp == 8'd0);
+      dbg_exp_odd      = exp_unbias_s[0];
+      dbg_exp_unbias   = exp_unbias_s;
+      dbg_raw_root     = raw_root;
+      dbg_guard_bit    = guard_bit;
+      dbg_sticky_bit   = sticky_bit;
+      dbg_round_up     = guard_bit & (raw_root[1] | sticky_bit);
+      dbg_round_carry  = rounded_ext[24];
       // dummy assignments for lint
       unused_sqrt_frac_msb = sqrt_frac[23];
       unused_rebias_hi    = rebias[9:8];
@@ -0,0 +1,162 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    fp32_sqrt_golden.h
+ * @brief   Memory-mapped golden table of f32_sqrt results for all FP32 inputs
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * File format written by gen_sqrt_golden (make sqrt_golden), host byte order:
+ * - 64-byte Header (magic "FP32SQRT", version, header size, entry count)
+ * - one uint32_t entry per input 0x00000000 .. 0x7f800000 (+0 to +inf)
+ *
+ * An entry is the SoftFloat result with the inexact flag folded into bit 31,
+ * which is always clear in the square root of a non-negative input. No other
+ * flag can be raised for these inputs. Negative inputs and NaNs are not
+ * stored: their result is -0 or the canonical NaN and is produced by
+ * fp32_ref::sqrt() without touching the table.
+ *
+ * SqrtTable maps the file read-only; lookup() is a single memory read, so any
+ * testbench or emulator can use it as a near-zero-cost reference.
+ */
+
+#ifndef FP32_SQRT_GOLDEN_H
+#define FP32_SQRT_GOLDEN_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "fp32_ref_model.h"
+
+namespace fp32_golden {
+
+static constexpr char     MAGIC[8]      = {'F', 'P', '3', '2', 'S', 'Q', 'R', 'T'};
+static constexpr uint32_t VERSION       = 1;
+static constexpr uint32_t LAST_INPUT    = 0x7f800000;  // +inf; entries cover [+0, +inf]
+static constexpr uint64_t NUM_ENTRIES   = uint64_t(LAST_INPUT) + 1;
+static constexpr uint32_t ENTRY_INEXACT = 0x80000000;  // inexact flag in the (clear) sign bit
+
+/**
+ * @brief File header, padded to 64 bytes so the entries stay aligned
+ */
+struct Header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint64_t num_entries;
+  uint8_t  reserved[40];
+};
+static_assert(sizeof(Header) == 64, "golden table header must be 64 bytes");
+
+/**
+ * @brief Header describing a complete table
+ */
+inline Header make_header() {
+  Header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version     = VERSION;
+  h.header_size = sizeof(Header);
+  h.num_entries = NUM_ENTRIES;
+  return h;
+}
+
+/**
+ * @brief Pack a result for a non-negative, non-NaN input into a table entry
+ */
+inline uint32_t encode(const fp32_ref::Result& r) {
+  return r.y | ((r.flags & fp32_ref::FLAG_INEXACT) ? ENTRY_INEXACT : 0);
+}
+
+/**
+ * @brief Read-only memory mapping of a golden table file
+ */
+class SqrtTable {
+public:
+  SqrtTable() : map_(nullptr), size_(0), entries_(nullptr) {}
+  ~SqrtTable() { close(); }
+  SqrtTable(const SqrtTable&) = delete;
+  SqrtTable& operator=(const SqrtTable&) = delete;
+
+  /**
+   * @brief Map `path`; on failure `error` (if given) describes the problem
+   */
+  bool open(const std::string& path, std::string* error = nullptr) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail(error, "cannot open " + path);
+    struct stat st;
+    const uint64_t expected = sizeof(Header) + NUM_ENTRIES * sizeof(uint32_t);
+    if (fstat(fd, &st) != 0 || uint64_t(st.st_size) != expected) {
+      ::close(fd);
+      return fail(error, path + " has the wrong size for a complete table");
+    }
+    void* map = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return fail(error, "cannot mmap " + path);
+
+    const Header* h = static_cast<const Header*>(map);
+    if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION ||
+        h->header_size != sizeof(Header) || h->num_entries != NUM_ENTRIES) {
+      munmap(map, expected);
+      return fail(error, path + " is not a version " + std::to_string(VERSION) + " sqrt golden table");
+    }
+    map_     = map;
+    size_    = expected;
+    entries_ = reinterpret_cast<const uint32_t*>(static_cast<const char*>(map) + sizeof(Header));
+    return true;
+  }
+
+  void close() {
+    if (map_) munmap(map_, size_);
+    map_     = nullptr;
+    size_    = 0;
+    entries_ = nullptr;
+  }
+
+  bool is_open() const { return entries_ != nullptr; }
+
+  /**
+   * @brief Expected f32_sqrt result and flags for input `a` (table must be open)
+   */
+  fp32_ref::Result lookup(uint32_t a) const {
+    if (a <= LAST_INPUT) {
+      uint32_t e = entries_[a];
+      return {e & ~ENTRY_INEXACT, (e & ENTRY_INEXACT) ? fp32_ref::FLAG_INEXACT : uint8_t(0)};
+    }
+    return fp32_ref::sqrt(a);  // negatives and NaNs: special cases only
+  }
+
+private:
+  static bool fail(std::string* error, const std::string& msg) {
+    if (error) *error = msg;
+    return false;
+  }
+
+  void*           map_;
+  size_t          size_;
+  const uint32_t* entries_;
+};
+
+}  // namespace fp32_golden
+
+#endif  // FP32_SQRT_GOLDEN_H
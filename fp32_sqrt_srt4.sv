@@ -0,0 +1,196 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    fp32_sqrt_srt4.sv
+ * @brief   Radix-4 SRT mantissa square root core for fp32_sqrt_comb (SQRT_CORE = 1)
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Computes the same value as sqrt_pair in fp32_sqrt_comb.sv: the 25-bit root
+ * floor(sqrt({op, 25'd0})) (LSB = guard) plus the remainder-nonzero sticky
+ * bit, and in addition root[24:1] + 1, so the rounding step selects instead
+ * of incrementing.
+ *
+ * With x = op / 2^25 in [1/4, 1) and the root S in [1/2, 1), the recurrence
+ * (digit set {-2..2}, bound rho = 2/3) is
+ *   W[j] = 4^j * (x - S[j]^2),  W[j+1] = 4 * W[j] - s * (2 * S[j] + s * 4^-(j+1))
+ * for the digit s = s[j+1]. After 13 digits S has 26 fraction bits; its LSB
+ * is folded into the sticky bit.
+ *
+ * - The first two digits come from a 64-entry table indexed by the top 6
+ *   bits of x (S[2] = round(sqrt(x)) to 4 bits), and W[2] = 16 * x - 16 * S[2]^2
+ *   starts out as a carry-save pair, so no step is spent while S is coarse.
+ * - The partial remainder is kept in carry-save form (ws + wc, 30-bit two's
+ *   complement, 26 fraction bits), so each step is one 3:2 compressor row
+ *   instead of sqrt_pair's 50-bit compare and subtract.
+ * - Each digit is selected from an 8-bit estimate of 4 * W (sign, 3 integer
+ *   and 4 fraction bits of both words, added) and S[j] truncated to 4
+ *   fraction bits, against the threshold table srt4_threshold().
+ * - The root is converted on the fly: S and SM = S - 4^-j supply the
+ *   multiples 2 * S + s * 4^-(j+1) by concatenation, and SP = S + 4^-j is
+ *   formed for the digit above the last one, which holds the rounding LSB.
+ *   The last digit and the final remainder sign then select the truncated
+ *   root from S or SM, and the rounded-up root from SP or S.
+ *
+ * Only the last step has a carry-propagate adder: the remainder sign and
+ * zero test for the root correction and the sticky bit.
+ *
+ * @note Results are only meaningful for op in [2^23, 2^25)
+ */
+
+// Radix-4 SRT mantissa square root core
+module fp32_sqrt_srt4 (
+    input  logic [24:0] op,                // radicand mantissa, pre-shifted for odd exponents
+    output logic [25:0] root_sticky,       // sticky (bit25) + 25-bit root (LSB = guard)
+    output logic [24:0] root_inc           // root[24:1] + 1 (bit24 = carry)
+);
+
+  localparam int FIRST = 2;                // digits taken from the seed table
+  localparam int LAST  = 12;               // index of the last step (13 digits)
+
+  // Seed roots: entry i = round(16 * sqrt(x)) for x at the midpoint of
+  // [i / 64, (i + 1) / 64), i.e. round(sqrt(4 * i + 2)), and -(entry^2) mod 2^8
+  function automatic logic [4:0] seed_root(input int i);
+    begin
+      seed_root = 5'd16;
+      for (int n = 16; n >= 8; n--) begin
+        if (4 * i + 2 <= n * n + n) seed_root = 5'(n);
+      end
+    end
+  endfunction
+
+  logic [4:0] seed_rom [64];
+  logic [7:0] seed_sq_rom [64];
+  for (genvar i = 0; i < 64; i++) begin : g_seed_rom
+    assign seed_rom[i]    = seed_root(i);
+    assign seed_sq_rom[i] = 8'(256 - int'(seed_root(i)) * int'(seed_root(i)));
+  end
+
+  // Digit-selection thresholds m_k(r) in units of 2^-4 for the root interval
+  // r = floor(16 * S[j]), 7..16: digit k is chosen when the estimate is at
+  // least m_k and below m_(k+1). Each entry keeps the next remainder within
+  // the bound for every 4 * W, S in the interval and step j >= FIRST the
+  // estimate can stand for (estimate error < 2^-3).
+  function automatic logic signed [7:0] srt4_threshold(input logic [4:0] r, input int k);
+    logic signed [7:0] m2, m1, m0, mm1;
+    begin
+      case (r)
+        5'd7:    begin m2 = 8'sd22; m1 = 8'sd6;  m0 = -8'sd9;  mm1 = -8'sd23; end
+        5'd8:    begin m2 = 8'sd25; m1 = 8'sd7;  m0 = -8'sd10; mm1 = -8'sd25; end
+        5'd9:    begin m2 = 8'sd28; m1 = 8'sd7;  m0 = -8'sd11; mm1 = -8'sd29; end
+        5'd10:   begin m2 = 8'sd30; m1 = 8'sd8;  m0 = -8'sd13; mm1 = -8'sd32; end
+        5'd11:   begin m2 = 8'sd33; m1 = 8'sd9;  m0 = -8'sd14; mm1 = -8'sd35; end
+        5'd12:   begin m2 = 8'sd36; m1 = 8'sd9;  m0 = -8'sd15; mm1 = -8'sd39; end
+        5'd13:   begin m2 = 8'sd38; m1 = 8'sd10; m0 = -8'sd17; mm1 = -8'sd42; end
+        5'd14:   begin m2 = 8'sd41; m1 = 8'sd11; m0 = -8'sd18; mm1 = -8'sd45; end
+        5'd15:   begin m2 = 8'sd44; m1 = 8'sd11; m0 = -8'sd19; mm1 = -8'sd49; end
+        default: begin m2 = 8'sd45; m1 = 8'sd12; m0 = -8'sd21; mm1 = -8'sd52; end
+      endcase
+      case (k)
+        2:       srt4_threshold = m2;
+        1:       srt4_threshold = m1;
+        0:       srt4_threshold = m0;
+        default: srt4_threshold = mm1;
+      endcase
+    end
+  endfunction
+
+  // recurrence state (roots in units of 2^-26, bit26 = integer bit)
+  logic [4:0]  seed;                       // S[2] in units of 2^-4
+  logic [29:0] ws, wc;                     // carry-save partial remainder
+  logic [29:0] ws4, wc4;                   // both words shifted left by 2 (4 * W)
+  logic [29:0] fd;                         // selected multiple s * F, inverted for s > 0
+  logic signed [7:0] est;                  // estimate of 4 * W in units of 2^-4
+  logic [4:0]  row;                        // root interval for digit selection
+  logic signed [2:0] q;                    // root digit
+  logic [1:0]  dig_q, dig_qm, dig_qp;      // digit bits appended to S, SM and SP
+  logic [26:0] q_acc, qm_acc, qp_acc;      // on-the-fly root S, S - 4^-j and S + 4^-j
+  logic [26:0] q_next, qm_next;
+  logic [29:0] w_final;                    // assimilated final remainder
+  logic [1:0]  d_low;                      // last digit less the correction, mod 4
+  logic        d_neg;                      // ... is negative: the root bits above come from SM
+
+  always_comb begin
+    // seed: S[2] and W[2] = 16 * x - 16 * S[2]^2 as a carry-save pair
+    seed   = seed_rom[op[24:19]];
+    ws     = {op, 5'd0};
+    wc     = {seed_sq_rom[op[24:19]], 22'd0};
+    q_acc  = {seed, 22'd0};
+    qm_acc = {seed - 5'd1, 22'd0};
+    qp_acc = '0;
+    ws4    = '0;
+    wc4    = '0;
+    fd     = '0;
+    est    = '0;
+    row    = '0;
+    q      = '0;
+    dig_q  = '0;
+    dig_qm = '0;
+    dig_qp = '0;
+    q_next  = '0;
+    qm_next = '0;
+    for (int j = FIRST; j <= LAST; j++) begin
+      ws4 = {ws[27:0], 2'b00};
+      wc4 = {wc[27:0], 2'b00};
+      // digit selection from the truncated carry-save estimate
+      est = $signed(ws4[29:22] + wc4[29:22]);
+      row = q_acc[26:22];
+      if      (est >= srt4_threshold(row,  2)) q =  3'sd2;
+      else if (est >= srt4_threshold(row,  1)) q =  3'sd1;
+      else if (est >= srt4_threshold(row,  0)) q =  3'sd0;
+      else if (est >= srt4_threshold(row, -1)) q = -3'sd1;
+      else                                     q = -3'sd2;
+      // s * (2 * S + s * 4^-(j+1)), from S for s > 0 and from SM = S - 4^-j
+      // for s < 0; the low term lands below the bits of S, so it is OR-ed in
+      case (q)
+        3'sd2:   fd = ~({1'b0, q_acc, 2'b00} | (30'd4 << (24 - 2 * j)));
+        3'sd1:   fd = ~({2'b00, q_acc, 1'b0} | (30'd1 << (24 - 2 * j)));
+        -3'sd1:  fd =  {2'b00, qm_acc, 1'b0} | (30'd7 << (24 - 2 * j));
+        -3'sd2:  fd =  {1'b0, qm_acc, 2'b00} | (30'd12 << (24 - 2 * j));
+        default: fd = '0;
+      endcase
+      // 3:2 compressor row; the +1 of the inversion enters the free carry LSB
+      ws = ws4 ^ wc4 ^ fd;
+      wc = {(ws4[28:0] & wc4[28:0]) | (ws4[28:0] & fd[28:0]) | (wc4[28:0] & fd[28:0]), q > 3'sd0};
+      // on-the-fly conversion, digits taken mod 4 at weight 4^-(j+1):
+      //   S  <- (s < 0 ? SM : S) + s,  SM <- (s > 0 ? S : SM) + s - 1,
+      //   SP <- (s < -1 ? SM : S) + s + 1
+      // the last digit is not appended (see below)
+      if (j < LAST) begin
+        dig_q   = q[1:0];
+        dig_qm  = q[1:0] + 2'd3;
+        dig_qp  = q[1:0] + 2'd1;
+        q_next  = ((q < 3'sd0) ? qm_acc : q_acc) | ({25'd0, dig_q} << (24 - 2 * j));
+        qm_next = ((q > 3'sd0) ? q_acc : qm_acc) | ({25'd0, dig_qm} << (24 - 2 * j));
+        qp_acc  = ((q < -3'sd1) ? qm_acc : q_acc) | ({25'd0, dig_qp} << (24 - 2 * j));
+        q_acc   = q_next;
+        qm_acc  = qm_next;
+      end
+    end
+    // The final root is S + d with d = s[13] - (W < 0) in {-3..2}: S holds
+    // bits 25:2 (root[24:1]), d only adds the guard and LSB bits, and a
+    // negative d borrows from S, i.e. takes SM. Rounding up adds one at
+    // bit 2 of the final root, which is S, or SP when d >= 0.
+    w_final     = ws + wc;
+    d_low       = q[1:0] - {1'b0, w_final[29]};
+    d_neg       = (q < 3'sd0) || (q == 3'sd0 && w_final[29]);
+    root_sticky = {d_low[0] | (|w_final), d_neg ? qm_acc[25:2] : q_acc[25:2], d_low[1]};
+    root_inc    = d_neg ? q_acc[26:2] : qp_acc[26:2];
+  end
+
+endmodule
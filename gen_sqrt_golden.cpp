@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    gen_sqrt_golden.cpp
+ * @brief   Generator for the FP32 square-root golden table
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Evaluates SoftFloat f32_sqrt for every input from +0 to +inf and writes the
+ * results in the fp32_sqrt_golden.h format (about 8.5 GB). The input range is
+ * split into 2^24-input chunks computed on worker threads and written at their
+ * final offsets. The table is written to FILE.tmp and renamed to FILE only once
+ * it is complete.
+ *
+ * @usage
+ * ./gen_sqrt_golden [-j N|--jobs N] [FILE]
+ *   -j, --jobs N     Number of worker threads (0 = all cores, default)
+ *   FILE             Output table (default: sqrt_golden.bin)
+ *
+ * @note Requires SoftFloat built via `make softfloat` (RISC-V specialization)
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "fp32_sqrt_golden.h"
+#include "tb_common.h"
+extern "C" {
+#include "softfloat.h"
+}
+
+static constexpr int      CHUNK_BITS = 24;
+static constexpr uint64_t CHUNK_SIZE = 1ull << CHUNK_BITS;
+
+/**
+ * @brief pwrite() all of buf at offset, retrying short writes
+ */
+static bool write_at(int fd, const void* buf, size_t len, uint64_t offset) {
+  const char* p = static_cast<const char*>(buf);
+  while (len > 0) {
+    ssize_t n = pwrite(fd, p, len, static_cast<off_t>(offset));
+    if (n <= 0) return false;
+    p += n;
+    len -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  long requested_jobs = 0;
+  std::string path = "sqrt_golden.bin";
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+      requested_jobs = strtol(argv[++i], nullptr, 0);
+    } else {
+      path = argv[i];
+    }
+  }
+  unsigned jobs = tb::resolve_jobs(requested_jobs);
+  if (jobs > 1 && !tb::softfloat_thread_safe()) jobs = 1;
+
+  const std::string tmp_path = path + ".tmp";
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    std::cout << "ERROR: cannot create " << tmp_path << std::endl;
+    return 1;
+  }
+  const fp32_golden::Header header = fp32_golden::make_header();
+  if (!write_at(fd, &header, sizeof(header), 0)) {
+    std::cout << "ERROR: cannot write " << tmp_path << std::endl;
+    close(fd);
+    return 1;
+  }
+
+  const uint32_t num_chunks = static_cast<uint32_t>((fp32_golden::NUM_ENTRIES + CHUNK_SIZE - 1) / CHUNK_SIZE);
+  std::vector<uint32_t> chunks(num_chunks);
+  for (uint32_t c = 0; c < num_chunks; ++c) chunks[c] = c;
+  tb::WorkQueue queue(chunks);
+  std::atomic<uint32_t> chunks_done(0);
+  std::cout << "Writing " << fp32_golden::NUM_ENTRIES << " entries to " << path
+            << " (" << jobs << " worker threads)" << std::endl;
+
+  tb::Stopwatch timer;
+  tb::ShardResult result = tb::run_workers(jobs, [&](unsigned, std::atomic<bool>& stop) {
+    tb::ShardResult shard;
+    std::vector<uint32_t> entries(CHUNK_SIZE);
+    uint32_t chunk;
+    while (!stop.load(std::memory_order_relaxed) && queue.claim(chunk)) {
+      uint64_t first = static_cast<uint64_t>(chunk) << CHUNK_BITS;
+      uint64_t count = std::min<uint64_t>(CHUNK_SIZE, fp32_golden::NUM_ENTRIES - first);
+      for (uint64_t i = 0; i < count; ++i) {
+        softfloat_exceptionFlags = 0;
+        float32_t a_sf;
+        a_sf.v = static_cast<uint32_t>(first + i);
+        float32_t r_sf = f32_sqrt(a_sf);
+        uint8_t flags = static_cast<uint8_t>(softfloat_exceptionFlags);
+        // Entries only encode the inexact flag and need a clear sign bit
+        if ((flags & ~fp32_ref::FLAG_INEXACT) || (r_sf.v & fp32_golden::ENTRY_INEXACT)) {
+          std::lock_guard<std::mutex> lock(tb::output_mutex());
+          std::cout << "ERROR: unencodable result for a=0x" << std::hex << a_sf.v << ": y=0x" << r_sf.v
+                    << " flags=0x" << (int)flags << std::dec << std::endl;
+          shard.failed = true;
+          return shard;
+        }
+        entries[i] = fp32_golden::encode({r_sf.v, flags});
+      }
+      if (!write_at(fd, entries.data(), count * sizeof(uint32_t), sizeof(header) + first * sizeof(uint32_t))) {
+        std::lock_guard<std::mutex> lock(tb::output_mutex());
+        std::cout << "ERROR: write failed for chunk " << chunk << std::endl;
+        shard.failed = true;
+        return shard;
+      }
+      shard.tested += count;
+
+      uint32_t done = ++chunks_done;
+      std::lock_guard<std::mutex> lock(tb::output_mutex());
+      std::cout << "[GOLDEN] chunk 0x" << std::hex << std::setw(2) << std::setfill('0') << chunk
+                << std::dec << " done (" << done << "/" << num_chunks << ")" << std::endl;
+    }
+    return shard;
+  });
+
+  bool ok = !result.failed && fsync(fd) == 0;
+  ok = (close(fd) == 0) && ok;
+  if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::cout << "Golden table generation FAILED" << std::endl;
+    unlink(tmp_path.c_str());
+    return 1;
+  }
+  std::cout << "Wrote " << result.tested << " entries in " << std::fixed << std::setprecision(1)
+            << timer.seconds() << " s" << std::endl;
+  return 0;
+}
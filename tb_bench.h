@@ -0,0 +1,152 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    tb_bench.h
+ * @brief   Per-stage throughput benchmark records and baseline regression check
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Support for the testbench --bench mode (make bench):
+ * - time_ns_per_vector(): best-of-N wall time of one stage after a warm-up
+ *   run, in ns/vector
+ * - BenchReport: collects (unit, region, stage) records, appends them to
+ *   bench_output.txt and compares them with a stored baseline
+ *
+ * Record format, one per line, whitespace separated and sorted as measured:
+ *   <unit> <region> <stage> <ns_per_vector>
+ * Lines starting with '#' are comments. A baseline file is simply a copy of
+ * an earlier bench_output.txt.
+ */
+
+#ifndef TB_BENCH_H
+#define TB_BENCH_H
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "tb_common.h"
+
+namespace tb {
+
+// Absolute slack added to every regression limit, so stages costing only a
+// few ns/vector do not fail on timer noise
+static constexpr double BENCH_SLACK_NS = 2.0;
+
+/**
+ * @brief Best-of-`repeats` wall time of fn() over `vectors` vectors, in ns/vector
+ *
+ * One untimed warm-up call precedes the timed repeats.
+ */
+template <typename Fn>
+double time_ns_per_vector(uint64_t vectors, int repeats, Fn fn) {
+  fn();
+  double best = 0.0;
+  for (int r = 0; r < repeats; ++r) {
+    Stopwatch timer;
+    fn();
+    double s = timer.seconds();
+    if (r == 0 || s < best) best = s;
+  }
+  return vectors ? best * 1e9 / vectors : 0.0;
+}
+
+/**
+ * @brief Benchmark records of one unit, with file output and baseline check
+ */
+class BenchReport {
+public:
+  explicit BenchReport(const std::string& unit) : unit_(unit) {}
+
+  void add(const std::string& region, const std::string& stage, double ns) {
+    records_.push_back({region, stage, ns});
+    std::printf("%-5s %-20s %-14s %10.3f ns/vector\n", unit_.c_str(), region.c_str(), stage.c_str(), ns);
+  }
+
+  /**
+   * @brief Append the records to `path` (header written when the file is new)
+   */
+  bool write(const std::string& path) const {
+    bool fresh = true;
+    if (FILE* in = std::fopen(path.c_str(), "r")) {
+      fresh = false;
+      std::fclose(in);
+    }
+    FILE* fp = std::fopen(path.c_str(), "a");
+    if (!fp) return false;
+    if (fresh) std::fprintf(fp, "# unit region stage ns_per_vector\n");
+    for (const auto& r : records_) {
+      std::fprintf(fp, "%s %s %s %.3f\n", unit_.c_str(), r.region.c_str(), r.stage.c_str(), r.ns);
+    }
+    std::fclose(fp);
+    return true;
+  }
+
+  /**
+   * @brief Compare with the baseline records of this unit
+   * @return false if any stage is slower than
+   *         baseline * (1 + tolerance_pct / 100) + BENCH_SLACK_NS,
+   *         or the baseline cannot be read
+   */
+  bool check_baseline(const std::string& path, double tolerance_pct) const {
+    FILE* fp = std::fopen(path.c_str(), "r");
+    if (!fp) {
+      std::cout << "ERROR: cannot read bench baseline " << path << std::endl;
+      return false;
+    }
+    std::map<std::string, double> baseline;
+    char line[256], unit[64], region[64], stage[64];
+    double ns;
+    while (std::fgets(line, sizeof(line), fp)) {
+      if (line[0] == '#') continue;
+      if (std::sscanf(line, "%63s %63s %63s %lf", unit, region, stage, &ns) == 4 && unit_ == unit) {
+        baseline[std::string(region) + " " + stage] = ns;
+      }
+    }
+    std::fclose(fp);
+
+    int regressions = 0, compared = 0;
+    for (const auto& r : records_) {
+      auto it = baseline.find(r.region + " " + r.stage);
+      if (it == baseline.end()) continue;
+      ++compared;
+      double limit = it->second * (1.0 + tolerance_pct / 100.0) + BENCH_SLACK_NS;
+      if (r.ns > limit) {
+        std::printf("REGRESSION: %s %s %s %.3f ns/vector (baseline %.3f, limit %.3f)\n",
+                    unit_.c_str(), r.region.c_str(), r.stage.c_str(), r.ns, it->second, limit);
+        ++regressions;
+      }
+    }
+    std::cout << "Baseline check: " << compared << " stages compared, " << regressions
+              << " regressions (tolerance " << tolerance_pct << "%)" << std::endl;
+    return regressions == 0;
+  }
+
+private:
+  struct Record {
+    std::string region, stage;
+    double ns;
+  };
+  std::string         unit_;
+  std::vector<Record> records_;
+};
+
+}  // namespace tb
+
+#endif  // TB_BENCH_H
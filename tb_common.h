@@ -0,0 +1,559 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    tb_common.h
+ * @brief   Shared harness utilities for the FP32 combinational testbenches
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Header-only helpers used by tb_fp32_div_comb.cpp and tb_fp32_sqrt_comb.cpp:
+ * - Sharded multi-threaded execution of a vector index range
+ * - Dynamic work queue with on-disk checkpointing of completed chunks
+ * - Serialized console output for concurrent workers
+ * - Wall-clock timing for throughput reporting
+ * - Counter-based random streams keyed by (seed, vector index), so any
+ *   random vector can be regenerated and replayed on its own
+ * - Persistent failure corpus, replayed before the long random phase
+ * - Runtime-loaded test settings and operand vector files, so test counts,
+ *   region weights and corner cases change without rebuilding the model
+ *
+ * Every worker owns its own Verilated model (in its own VerilatedContext)
+ * and relies on SoftFloat being built with a thread-local exception state
+ * (THREAD_LOCAL, see Makefile), so workers share nothing but the stop flag.
+ */
+
+#ifndef TB_COMMON_H
+#define TB_COMMON_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tb {
+
+/**
+ * @brief Mutex serializing console output from concurrent workers
+ */
+inline std::mutex& output_mutex() {
+  static std::mutex m;
+  return m;
+}
+
+/**
+ * @brief True when SoftFloat state is thread-local and workers may run in parallel
+ */
+inline bool softfloat_thread_safe() {
+#ifdef THREAD_LOCAL
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Resolve a requested worker count (0 selects one worker per core)
+ */
+inline unsigned resolve_jobs(long requested) {
+  if (requested <= 0) {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+  }
+  return static_cast<unsigned>(requested);
+}
+
+/**
+ * @brief Outcome of one worker's shard (and of the merged run)
+ */
+struct ShardResult {
+  uint64_t tested = 0;      // vectors checked
+  bool     failed = false;  // a mismatch was found
+};
+
+/**
+ * @brief Run fn(worker, stop) on `jobs` threads and merge their results
+ *
+ * The first worker that fails raises `stop`; the others poll it and return
+ * early. A single job runs inline on the calling thread.
+ */
+template <typename Fn>
+ShardResult run_workers(unsigned jobs, Fn fn) {
+  std::vector<ShardResult> results(jobs);
+  std::atomic<bool> stop(false);
+  auto run_one = [&](unsigned w) {
+    results[w] = fn(w, stop);
+    if (results[w].failed) stop = true;
+  };
+
+  if (jobs <= 1) {
+    run_one(0);
+  } else {
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < jobs; ++w) workers.emplace_back(run_one, w);
+    for (auto& t : workers) t.join();
+  }
+
+  ShardResult merged;
+  for (const auto& r : results) {
+    merged.tested += r.tested;
+    merged.failed |= r.failed;
+  }
+  return merged;
+}
+
+/**
+ * @brief Run fn(worker, begin, end, stop) over [0, total) on `jobs` threads
+ *
+ * The index space is cut into contiguous, near-equal shards, one per worker.
+ */
+template <typename Fn>
+ShardResult run_sharded(unsigned jobs, uint64_t total, Fn fn) {
+  return run_workers(jobs, [&](unsigned w, std::atomic<bool>& stop) {
+    return fn(w, total * w / jobs, total * (w + 1) / jobs, stop);
+  });
+}
+
+/**
+ * @brief Lock-free queue handing out a fixed list of work items to workers
+ *
+ * Used for sweeps split into chunks of uneven cost, where static sharding
+ * would leave workers idle.
+ */
+class WorkQueue {
+public:
+  explicit WorkQueue(std::vector<uint32_t> items) : items_(std::move(items)), next_(0) {}
+  bool claim(uint32_t& item) {
+    size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+    if (i >= items_.size()) return false;
+    item = items_[i];
+    return true;
+  }
+private:
+  std::vector<uint32_t> items_;
+  std::atomic<size_t>   next_;
+};
+
+/**
+ * @brief Completed-chunk set persisted as a text file (one chunk id per line)
+ *
+ * The first line is a tag identifying the sweep; a file with a different tag
+ * is rejected rather than resumed. Each completed chunk is appended and
+ * flushed immediately, so a killed run loses at most the chunks in flight.
+ */
+class ChunkCheckpoint {
+public:
+  ChunkCheckpoint(const std::string& path, const std::string& tag, uint32_t num_chunks)
+      : path_(path), tag_(tag), done_(num_chunks, false), fp_(nullptr) {}
+  ~ChunkCheckpoint() { if (fp_) fclose(fp_); }
+
+  /**
+   * @brief Load previously completed chunks and open the file for appending
+   * @return false if the file belongs to a different sweep or cannot be written
+   */
+  bool open() {
+    if (FILE* in = fopen(path_.c_str(), "r")) {
+      char line[256];
+      bool tag_ok = fgets(line, sizeof(line), in) && std::string(line) == "# " + tag_ + "\n";
+      if (!tag_ok) {
+        fclose(in);
+        return false;
+      }
+      unsigned long chunk;
+      while (fscanf(in, "%lu", &chunk) == 1) {
+        if (chunk < done_.size()) done_[chunk] = true;
+      }
+      fclose(in);
+      fp_ = fopen(path_.c_str(), "a");
+    } else {
+      fp_ = fopen(path_.c_str(), "w");
+      if (fp_) {
+        fprintf(fp_, "# %s\n", tag_.c_str());
+        fflush(fp_);
+      }
+    }
+    return fp_ != nullptr;
+  }
+
+  bool done(uint32_t chunk) const { return done_[chunk]; }
+
+  /**
+   * @brief Chunk ids not yet completed, in ascending order
+   */
+  std::vector<uint32_t> pending() const {
+    std::vector<uint32_t> ids;
+    for (uint32_t c = 0; c < done_.size(); ++c) {
+      if (!done_[c]) ids.push_back(c);
+    }
+    return ids;
+  }
+
+  /**
+   * @brief Record a completed chunk (thread-safe)
+   */
+  void mark_done(uint32_t chunk) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_[chunk] = true;
+    fprintf(fp_, "%u\n", chunk);
+    fflush(fp_);
+  }
+
+private:
+  std::string       path_;
+  std::string       tag_;
+  std::vector<bool> done_;
+  FILE*             fp_;
+  std::mutex        mutex_;
+};
+
+/**
+ * @brief Read hex operand vectors from a text file (`num_operands` words per line)
+ *
+ * Anything after the operands is ignored, so lines may carry trailing
+ * comments or extra fields. Lines starting with '#' are comments.
+ * @return false if the file cannot be read or a line is malformed; `bad_line`
+ *         receives the 1-based number of the first malformed line (0 if unreadable)
+ */
+inline bool load_vectors(const std::string& path, unsigned num_operands,
+                         std::vector<std::vector<uint32_t>>& out, unsigned* bad_line = nullptr) {
+  if (bad_line) *bad_line = 0;
+  FILE* fp = fopen(path.c_str(), "r");
+  if (!fp) return false;
+  char line[512];
+  unsigned line_no = 0;
+  bool ok = true;
+  while (fgets(line, sizeof(line), fp)) {
+    ++line_no;
+    const char* p = line;
+    while (*p == ' ' || *p == '\t') ++p;
+    if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+    std::vector<uint32_t> ops;
+    for (unsigned k = 0; k < num_operands; ++k) {
+      char* end = nullptr;
+      unsigned long v = strtoul(p, &end, 16);
+      if (end == p) break;
+      ops.push_back(static_cast<uint32_t>(v));
+      p = end;
+    }
+    if (ops.size() != num_operands) {
+      if (ok && bad_line) *bad_line = line_no;
+      ok = false;
+      continue;
+    }
+    out.push_back(ops);
+  }
+  fclose(fp);
+  return ok;
+}
+
+/**
+ * @brief Read a settings file: one "key value..." entry per line
+ *
+ * Tokens are whitespace separated; '#' starts a comment anywhere on a line.
+ * Interpreting the keys is left to the testbench.
+ * @return false if the file cannot be read
+ */
+inline bool load_settings(const std::string& path, std::vector<std::vector<std::string>>& entries) {
+  FILE* fp = fopen(path.c_str(), "r");
+  if (!fp) return false;
+  char line[512];
+  while (fgets(line, sizeof(line), fp)) {
+    std::string text(line);
+    size_t hash = text.find('#');
+    if (hash != std::string::npos) text.erase(hash);
+    std::istringstream tokens(text);
+    std::vector<std::string> entry;
+    std::string token;
+    while (tokens >> token) entry.push_back(token);
+    if (!entry.empty()) entries.push_back(entry);
+  }
+  fclose(fp);
+  return true;
+}
+
+/**
+ * @brief Resolve `path` relative to the directory of `base_file` (absolute paths unchanged)
+ */
+inline std::string resolve_relative(const std::string& base_file, const std::string& path) {
+  if (path.empty() || path[0] == '/') return path;
+  size_t slash = base_file.rfind('/');
+  return slash == std::string::npos ? path : base_file.substr(0, slash + 1) + path;
+}
+
+/**
+ * @brief Parse a non-negative count (decimal or 0x hex) from a settings value or argument
+ */
+inline bool parse_count(const std::string& text, uint64_t& value) {
+  if (text.empty() || text[0] == '-') return false;
+  char* end = nullptr;
+  value = std::strtoull(text.c_str(), &end, 0);
+  return *end == '\0';
+}
+
+/**
+ * @brief On-disk corpus of failing vectors (one vector per line)
+ *
+ * Line format: the operands as hex words, optionally followed by the expected
+ * result and flags, the actual RTL result and flags, and the phase that found
+ * the failure. Only the operands are read back; the expected result is always
+ * recomputed, so a hand-written line with just operands is a valid entry.
+ * Lines starting with '#' are comments. Appends are deduplicated by operands
+ * and flushed immediately.
+ */
+class FailureCorpus {
+public:
+  typedef std::vector<uint32_t> Operands;
+
+  FailureCorpus(const std::string& unit, unsigned num_operands)
+      : unit_(unit), num_operands_(num_operands) {}
+
+  /**
+   * @brief Load entries from `path`; a missing file is an empty corpus
+   * @return false if the file exists but has a malformed line
+   */
+  bool load(const std::string& path) {
+    path_ = path;
+    entries_.clear();
+    known_.clear();
+    if (FILE* in = fopen(path.c_str(), "r")) {
+      fclose(in);
+    } else {
+      return true;
+    }
+    std::vector<Operands> loaded;
+    bool ok = load_vectors(path, num_operands_, loaded);
+    for (const Operands& ops : loaded) {
+      if (known_.insert(ops).second) entries_.push_back(ops);
+    }
+    return ok;
+  }
+
+  const std::string& path() const { return path_; }
+  const std::vector<Operands>& entries() const { return entries_; }
+
+  /**
+   * @brief Append a failing vector unless its operands are already recorded (thread-safe)
+   */
+  void append(const Operands& ops, uint32_t expected, unsigned expected_flags,
+              uint32_t actual, unsigned actual_flags, const char* source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path_.empty() || !known_.insert(ops).second) return;
+    bool fresh = true;
+    if (FILE* in = fopen(path_.c_str(), "r")) {
+      fresh = false;
+      fclose(in);
+    }
+    FILE* fp = fopen(path_.c_str(), "a");
+    if (!fp) return;
+    if (fresh) {
+      fprintf(fp, "# %s failure corpus: operands expected expected_flags actual actual_flags source\n", unit_.c_str());
+    }
+    for (uint32_t op : ops) fprintf(fp, "0x%08x ", op);
+    fprintf(fp, "0x%08x 0x%02x 0x%08x 0x%02x %s\n", expected, expected_flags, actual, actual_flags, source);
+    fclose(fp);
+    entries_.push_back(ops);
+  }
+
+private:
+  std::string           unit_;
+  unsigned              num_operands_;
+  std::string           path_;
+  std::vector<Operands> entries_;
+  std::set<Operands>    known_;
+  std::mutex            mutex_;
+};
+
+/**
+ * @brief SplitMix64 finalizer: bijective 64-bit mixing function
+ */
+inline uint64_t mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @brief Counter-based random stream of one test vector
+ *
+ * Draw k of vector `index` is a pure function of (seed, index, k), so a
+ * vector is regenerated from its seed and index alone and workers sharing a
+ * seed need no common generator state.
+ */
+class VectorRng {
+public:
+  VectorRng(uint64_t seed, uint64_t index) : key_(key(seed, index)), counter_(0) {}
+  // Stream of a key from key() or keys()
+  explicit VectorRng(uint64_t key) : key_(key), counter_(0) {}
+
+  static uint64_t key(uint64_t seed, uint64_t index) { return mix64(seed ^ mix64(index + GAMMA)); }
+
+  /**
+   * @brief Keys of vectors first..first+n-1: a branch-free loop the compiler can vectorize
+   */
+  static void keys(uint64_t seed, uint64_t first, size_t n, uint64_t* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = key(seed, first + i);
+  }
+
+  uint32_t next() { return static_cast<uint32_t>(mix64(key_ + ++counter_ * GAMMA) >> 32); }
+
+  /**
+   * @brief Unbiased draw from [0, bound), bound > 0
+   *
+   * Lemire's multiply-shift: the high word of next() * bound, rejecting the
+   * (2^32 mod bound) low words that would favour some results. The
+   * rejection test needs a division only when the low word is below bound.
+   */
+  uint32_t below(uint32_t bound) {
+    uint64_t m = static_cast<uint64_t>(next()) * bound;
+    if (static_cast<uint32_t>(m) < bound) {
+      uint32_t threshold = (0u - bound) % bound;
+      while (static_cast<uint32_t>(m) < threshold) m = static_cast<uint64_t>(next()) * bound;
+    }
+    return static_cast<uint32_t>(m >> 32);
+  }
+
+private:
+  static constexpr uint64_t GAMMA = 0x9e3779b97f4a7c15ull;  // SplitMix64 increment
+  uint64_t key_;
+  uint64_t counter_;
+};
+
+/**
+ * @brief Alias table over integer weights (Vose's method)
+ *
+ * pick() takes two bounded draws and no search: column c of n keeps its own
+ * index with probability cut[c] / total and yields alias[c] otherwise. All
+ * arithmetic is integer (each column holds `total` units, weight w fills
+ * w * n of them), so index i comes out with probability exactly
+ * weight[i] / total.
+ */
+class AliasTable {
+public:
+  /**
+   * @brief Rebuild from `weights`; their sum must be nonzero and below 2^32
+   */
+  void build(const std::vector<uint64_t>& weights) {
+    size_t n = weights.size();
+    total_ = 0;
+    for (uint64_t w : weights) total_ += static_cast<uint32_t>(w);
+    cut_.assign(n, total_);
+    alias_.resize(n);
+    std::vector<uint64_t> fill(n);
+    std::vector<size_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+      alias_[i] = static_cast<uint32_t>(i);
+      fill[i] = weights[i] * n;
+      (fill[i] < total_ ? small : large).push_back(i);
+    }
+    // Top up each underfull column from an overfull one; columns left over
+    // in either list are exactly full, since the fills sum to n * total
+    while (!small.empty() && !large.empty()) {
+      size_t s = small.back(), l = large.back();
+      small.pop_back();
+      cut_[s] = static_cast<uint32_t>(fill[s]);
+      alias_[s] = static_cast<uint32_t>(l);
+      fill[l] -= total_ - fill[s];
+      if (fill[l] < total_) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+  }
+
+  size_t pick(VectorRng& rng) const {
+    uint32_t c = rng.below(static_cast<uint32_t>(cut_.size()));
+    return rng.below(total_) < cut_[c] ? c : alias_[c];
+  }
+
+private:
+  uint32_t              total_ = 0;
+  std::vector<uint32_t> cut_;
+  std::vector<uint32_t> alias_;
+};
+
+static constexpr size_t COMPARE_STRIDE = 64;  // Entries per OR reduction in find_mismatches()
+
+/**
+ * @brief Indices i < n where (y[i], flags[i]) differs bitwise from (ref[i].y, ref[i].flags)
+ *
+ * Each stride of COMPARE_STRIDE entries is first OR-reduced without
+ * branches, a loop the compiler vectorizes; only strides with a difference
+ * are scanned for their indices. `out` needs room for n entries.
+ * @return Number of indices written to `out`, in increasing order
+ */
+template <typename Result>
+inline size_t find_mismatches(const uint32_t* y, const uint8_t* flags, const Result* ref, size_t n,
+                              uint32_t* out) {
+  size_t count = 0;
+  for (size_t base = 0; base < n; base += COMPARE_STRIDE) {
+    size_t end = n - base < COMPARE_STRIDE ? n : base + COMPARE_STRIDE;
+    uint32_t diff = 0;
+    for (size_t i = base; i < end; ++i) diff |= (y[i] ^ ref[i].y) | static_cast<uint32_t>(flags[i] ^ ref[i].flags);
+    if (!diff) continue;
+    for (size_t i = base; i < end; ++i) {
+      out[count] = static_cast<uint32_t>(i);
+      count += (y[i] != ref[i].y) | (flags[i] != ref[i].flags);
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Fresh 64-bit seed for runs without --seed
+ */
+inline uint64_t random_seed() {
+  std::random_device rd;
+  return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
+
+/**
+ * @brief Parse a --replay argument of the form "seed:index" (decimal or 0x hex)
+ */
+inline bool parse_replay(const char* arg, uint64_t& seed, uint64_t& index) {
+  char* end = nullptr;
+  seed = std::strtoull(arg, &end, 0);
+  if (end == arg || *end != ':') return false;
+  const char* rest = end + 1;
+  index = std::strtoull(rest, &end, 0);
+  return end != rest && *end == '\0';
+}
+
+/**
+ * @brief Wall-clock stopwatch for vectors/sec reporting
+ */
+class Stopwatch {
+public:
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+  double seconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+  }
+private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace tb
+
+#endif  // TB_COMMON_H
@@ -0,0 +1,311 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    tb_coverage.h
+ * @brief   Functional coverage bins over the datapath debug signals
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * A cross-coverage group: each dimension is a small set of labelled values
+ * (e.g. path, lz_q, guard/sticky, round_up, flags) and every combination is
+ * one bin with a hit counter. The testbench maps the debug signals of each
+ * evaluated vector to one bin.
+ *
+ * Per bin the group also keeps the index of the first random (or sweep)
+ * vector that hit it, so the report can tell after how many random vectors
+ * the last new bin appeared. Combinations the datapath cannot produce are
+ * declared impossible: they are left out of the coverage ratio, and hits on
+ * them are reported as unexpected.
+ *
+ * Each worker fills its own group; groups are merged after the run, so the
+ * hot loop does no synchronization.
+ *
+ * AdaptiveWeights closes the loop for --adaptive runs: it attributes bin
+ * hits to the operand source (region or directed target) that produced them
+ * and derives new sampling weights from the bins still rare or unreached.
+ */
+
+#ifndef TB_COVERAGE_H
+#define TB_COVERAGE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace tb {
+
+// First-hit index of a bin not (yet) hit by a random or sweep vector
+static constexpr uint64_t COVERAGE_NO_INDEX = ~0ull;
+
+/**
+ * @brief Cross-coverage group with per-bin hit counts and first random hit
+ */
+class Coverage {
+public:
+  struct Dimension {
+    std::string              name;
+    std::vector<std::string> labels;
+  };
+
+  Coverage(const std::string& title, const std::vector<Dimension>& dims) : title_(title), dims_(dims) {
+    size_t bins = 1;
+    for (const auto& d : dims_) bins *= d.labels.size();
+    hits_.assign(bins, 0);
+    first_random_.assign(bins, COVERAGE_NO_INDEX);
+    impossible_.assign(bins, false);
+  }
+
+  /**
+   * @brief Declare impossible every bin for which pred(values) is true
+   *
+   * `values` holds one label index per dimension, in dimension order.
+   */
+  template <typename Pred>
+  void mark_impossible(Pred pred) {
+    std::vector<unsigned> values(dims_.size());
+    for (size_t bin = 0; bin < hits_.size(); ++bin) {
+      decode(bin, values);
+      if (pred(values.data())) impossible_[bin] = true;
+    }
+  }
+
+  /**
+   * @brief Bin index of one label index per dimension (mixed radix, first dimension most significant)
+   */
+  size_t bin(std::initializer_list<unsigned> values) const {
+    size_t index = 0, d = 0;
+    for (unsigned v : values) index = index * dims_[d++].labels.size() + v;
+    return index;
+  }
+
+  /**
+   * @brief Count a directed (corner-case or systematic) vector
+   */
+  void hit(size_t bin) { ++hits_[bin]; }
+
+  /**
+   * @brief Count random (or sweep) vector `index`
+   */
+  void hit(size_t bin, uint64_t index) {
+    ++hits_[bin];
+    if (index < first_random_[bin]) first_random_[bin] = index;
+  }
+
+  size_t   bins() const { return hits_.size(); }
+  uint64_t hits(size_t bin) const { return hits_[bin]; }
+  bool     impossible(size_t bin) const { return impossible_[bin]; }
+
+  /**
+   * @brief Label index of every dimension of `bin`, in dimension order
+   */
+  std::vector<unsigned> values(size_t bin) const {
+    std::vector<unsigned> v(dims_.size());
+    decode(bin, v);
+    return v;
+  }
+
+  /**
+   * @brief Number of possible bins not hit yet
+   */
+  size_t unreached() const {
+    size_t n = 0;
+    for (size_t b = 0; b < hits_.size(); ++b) n += !impossible_[b] && !hits_[b];
+    return n;
+  }
+
+  /**
+   * @brief Add the hits of another group with the same dimensions
+   */
+  void merge(const Coverage& other) {
+    for (size_t b = 0; b < hits_.size(); ++b) {
+      hits_[b] += other.hits_[b];
+      if (other.first_random_[b] < first_random_[b]) first_random_[b] = other.first_random_[b];
+    }
+  }
+
+  /**
+   * @brief Print the coverage summary, unreached bins (at most max_listed) and unexpected hits
+   * @return false if a bin declared impossible was hit
+   */
+  bool report(size_t max_listed) const {
+    size_t possible = 0, covered = 0, directed_only = 0, unexpected = 0;
+    uint64_t last_new = 0;
+    for (size_t b = 0; b < hits_.size(); ++b) {
+      if (impossible_[b]) {
+        if (hits_[b]) ++unexpected;
+        continue;
+      }
+      ++possible;
+      if (!hits_[b]) continue;
+      ++covered;
+      if (first_random_[b] == COVERAGE_NO_INDEX) {
+        ++directed_only;
+      } else if (first_random_[b] + 1 > last_new) {
+        last_new = first_random_[b] + 1;
+      }
+    }
+
+    std::cout << "\n=== Coverage: " << title_ << " ===" << std::endl;
+    std::printf("Bins: %zu (%zu possible), hit %zu (%.1f%%)\n", hits_.size(), possible, covered,
+                possible ? 100.0 * covered / possible : 0.0);
+    std::cout << "Hit only by corner/systematic vectors: " << directed_only << std::endl;
+    std::cout << "Random vectors needed to reach the other bins: " << last_new << std::endl;
+
+    std::vector<unsigned> values(dims_.size());
+    size_t listed = 0;
+    std::cout << "Unreached bins: " << (possible - covered) << std::endl;
+    for (size_t b = 0; b < hits_.size(); ++b) {
+      if (impossible_[b] || hits_[b]) continue;
+      if (listed++ == max_listed) {
+        std::cout << "  ... (use --coverage-out for the full list)" << std::endl;
+        break;
+      }
+      std::cout << "  " << describe(b, values) << std::endl;
+    }
+    for (size_t b = 0; b < hits_.size(); ++b) {
+      if (impossible_[b] && hits_[b]) {
+        std::cout << "UNEXPECTED: " << hits_[b] << " hits in impossible bin " << describe(b, values) << std::endl;
+      }
+    }
+    return unexpected == 0;
+  }
+
+  /**
+   * @brief Write every bin as "<hits> <first random index or -> <status> <dim=label...>"
+   */
+  bool write(const std::string& path) const {
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp) return false;
+    std::fprintf(fp, "# %s\n# hits first_random status bin\n", title_.c_str());
+    std::vector<unsigned> values(dims_.size());
+    for (size_t b = 0; b < hits_.size(); ++b) {
+      const char* status = impossible_[b] ? (hits_[b] ? "unexpected" : "impossible") : (hits_[b] ? "hit" : "unreached");
+      if (first_random_[b] == COVERAGE_NO_INDEX) {
+        std::fprintf(fp, "%llu - %s %s\n", (unsigned long long)hits_[b], status, describe(b, values).c_str());
+      } else {
+        std::fprintf(fp, "%llu %llu %s %s\n", (unsigned long long)hits_[b],
+                     (unsigned long long)first_random_[b], status, describe(b, values).c_str());
+      }
+    }
+    std::fclose(fp);
+    return true;
+  }
+
+private:
+  void decode(size_t bin, std::vector<unsigned>& values) const {
+    for (size_t d = dims_.size(); d-- > 0;) {
+      values[d] = static_cast<unsigned>(bin % dims_[d].labels.size());
+      bin /= dims_[d].labels.size();
+    }
+  }
+
+  std::string describe(size_t bin, std::vector<unsigned>& values) const {
+    decode(bin, values);
+    std::string text;
+    for (size_t d = 0; d < dims_.size(); ++d) {
+      if (d) text += ' ';
+      text += dims_[d].name + "=" + dims_[d].labels[values[d]];
+    }
+    return text;
+  }
+
+  std::string            title_;
+  std::vector<Dimension> dims_;
+  std::vector<uint64_t>  hits_;
+  std::vector<uint64_t>  first_random_;
+  std::vector<bool>      impossible_;
+};
+
+/**
+ * @brief Coverage-directed sampling weights for the random phase
+ *
+ * Sources are the operand generators the random phase picks from. After each
+ * epoch, update() scores every source by the rarity of the bins it reached
+ * (a bin hit by few vectors is worth more per hit) and by the unreached bins
+ * it is aimed at, and blends that with the configured base weights. Sources
+ * with a base weight never drop below 1, so no region is starved entirely.
+ */
+class AdaptiveWeights {
+public:
+  AdaptiveWeights(size_t sources, size_t bins)
+      : hits_(sources, std::vector<uint64_t>(bins, 0)), drawn_(sources, 0) {}
+
+  void record(size_t source, size_t bin) {
+    ++hits_[source][bin];
+    ++drawn_[source];
+  }
+
+  void merge(const AdaptiveWeights& other) {
+    for (size_t s = 0; s < hits_.size(); ++s) {
+      drawn_[s] += other.drawn_[s];
+      for (size_t b = 0; b < hits_[s].size(); ++b) hits_[s][b] += other.hits_[s][b];
+    }
+  }
+
+  /**
+   * @brief New integer weights summing to about `scale`
+   *
+   * aims(source, bin) tells whether a source is built to reach `bin`; the
+   * still unreached bins are shared among the sources aimed at them.
+   */
+  template <typename Aims>
+  std::vector<int> update(const Coverage& coverage, const std::vector<int>& base, int scale, Aims aims) const {
+    size_t sources = hits_.size();
+    std::vector<double> yield(sources, 0.0), aimed(sources, 0.0);
+    double base_sum = 0.0, yield_sum = 0.0, aimed_sum = 0.0;
+    for (size_t s = 0; s < sources; ++s) {
+      base_sum += base[s];
+      for (size_t b = 0; b < coverage.bins(); ++b) {
+        if (coverage.impossible(b)) continue;
+        if (coverage.hits(b)) {
+          yield[s] += static_cast<double>(hits_[s][b]) / coverage.hits(b);
+        } else if (aims(s, b)) {
+          aimed[s] += 1.0;
+        }
+      }
+      // Bin credit per vector drawn from this source
+      if (drawn_[s]) yield[s] /= drawn_[s];
+      yield_sum += yield[s];
+      aimed_sum += aimed[s];
+    }
+
+    // Unreached bins with a source aimed at them take half the weight
+    double w_base = aimed_sum > 0 ? 0.25 : 0.5, w_yield = w_base, w_aimed = aimed_sum > 0 ? 0.5 : 0.0;
+    std::vector<int> weights(sources);
+    for (size_t s = 0; s < sources; ++s) {
+      double share = (base_sum > 0 ? w_base * base[s] / base_sum : 0.0) +
+                     (yield_sum > 0 ? w_yield * yield[s] / yield_sum : 0.0) +
+                     (aimed_sum > 0 ? w_aimed * aimed[s] / aimed_sum : 0.0);
+      weights[s] = static_cast<int>(std::lround(share * scale));
+      if (base[s] > 0 && weights[s] < 1) weights[s] = 1;
+    }
+    return weights;
+  }
+
+private:
+  std::vector<std::vector<uint64_t>> hits_;  // [source][bin]
+  std::vector<uint64_t>              drawn_; // vectors per source
+};
+
+}  // namespace tb
+
+#endif  // TB_COVERAGE_H
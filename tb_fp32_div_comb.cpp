@@ -28,10 +28,70 @@
  * - Stratified random testing across the entire FP32 space
  * - Bit-accurate comparison with detailed ULP analysis
  * - Early termination on first failure for efficient debugging
+ * - Sharded multi-threaded random testing (one DUT per worker)
+ * - Native reference model (fp32_ref_model.h) or host-FPU batches with
+ *   SoftFloat fallback (fp32_host_ref.h) as fast hot-loop oracles,
+ *   validated against SoftFloat before use
+ * - Per-region throughput benchmark with baseline regression check (--bench)
+ * - Optional lane build (-DTB_LANES=N, make div_xN): the random phase checks N
+ *   vectors per eval() of the fp32_div_comb_xN wrapper
+ * - Persistent failure corpus: failing systematic and random vectors are
+ *   appended to div_corpus.txt and replayed before all other tests
+ * - Test counts, region weights and corner cases loaded at startup from
+ *   div_tests.cfg and div_corner_cases.txt, so they change without a rebuild
+ * - Functional coverage of the datapath debug signals (path x lz_q x
+ *   guard/sticky x round_up x flags) with a report of unreached bins
+ * - Adaptive mode (--adaptive): region weights re-derived from coverage every
+ *   epoch, with directed targets for the carry, underflow and exact-result bins
+ * - Hard-to-round phase: operands constructed (tb_hard_cases.h) so that the
+ *   quotient lies within 2^-19 of a guard-bit unit from a rounding midpoint
+ *   or a representable value
+ * - Exponent-band phase: random significands with operand exponents solved to
+ *   put the quotient exponent at the overflow, flush-to-zero and
+ *   gradual-underflow boundaries
+ * - Metamorphic amplification (metamorphic N): N sign-flipped or power-of-two
+ *   scaled variants per random vector, checked against the one reference
+ *   result (tb_metamorphic.h)
  * 
  * @usage
- * ./obj_dir/Vfp32_div_comb [-v|--verbose]
+ * ./obj_dir/Vfp32_div_comb [-v|--verbose] [-j N|--jobs N] [--ref softfloat|model|host] [--seed S]
+ *                          [--corpus FILE] [--config FILE] [--corners FILE] [-n N|--random-tests N]
+ *                          [--validation-tests N] [--subnorm-step N] [--boundary-range N] [--hard-tests N]
+ *                          [--band-tests N] [--metamorphic N]
+ *                          [--weight REGION=W ...] [--no-coverage] [--coverage-out FILE]
+ *                          [--adaptive] [--adapt-epoch N] [--keep-going]
+ * ./obj_dir/Vfp32_div_comb --replay SEED:INDEX
+ * ./obj_dir/Vfp32_div_comb --lockstep [-j N] [--seed S] [-n N] [--hard-tests N] [--band-tests N]
+ * ./obj_dir/Vfp32_div_comb --bench [--bench-out FILE] [--bench-baseline FILE] [--bench-tolerance PCT]
  *   -v, --verbose    Enable verbose output for all test cases
+ *   -j, --jobs N     Run the random phase on N worker threads (0 = all cores)
+ *   --ref BACKEND    Reference for the random phase (default: model)
+ *   --seed S         Seed of the stratified random phase (default: random, printed)
+ *   --replay S:I     Regenerate random vector I of seed S and check only that vector
+ *   --corpus FILE    Failure corpus to replay first and append to (default: div_corpus.txt,
+ *                    empty string disables it)
+ *   --config FILE    Test settings file (default: div_tests.cfg)
+ *   --corners FILE   Corner-case operand file (default: corner_file of the settings)
+ *   -n, --random-tests N, --validation-tests N, --subnorm-step N, --boundary-range N, --hard-tests N,
+ *   --band-tests N, --metamorphic N,
+ *   --weight REGION=W
+ *                    Override the corresponding settings; --replay needs the same
+ *                    settings and weights as the run that failed
+ *   --no-coverage    Skip coverage sampling (lane builds re-evaluate every vector on
+ *                    the scalar model to sample it)
+ *   --coverage-out FILE  Write hit count and first random hit of every coverage bin
+ *   --adaptive       Re-weight regions and directed targets toward rare and unreached
+ *                    coverage bins after every epoch of N random vectors (setting
+ *                    adapt_epoch); replay hints then carry that epoch's weights
+ *   --keep-going     Continue after mismatches; group them into classes (operand classes,
+ *                    datapath, ULP distance, differing flags) and print the classes with
+ *                    up to 3 representatives each at the end (exit code 1 if any)
+ *   --lockstep       Lockstep builds (make div_lockstep): compare the DUT bit for bit with
+ *                    the reference RTL on the corner, hard-to-round, exponent-band and
+ *                    random vectors, without SoftFloat
+ *   --bench          Measure per-region stage costs (ns/vector) instead of testing;
+ *                    append them to FILE (default: bench_output.txt) and fail if a
+ *                    stage is more than PCT% (default: 25) slower than the baseline
  * 
  * @note Requires SoftFloat library for reference calculations
  */
@@ -39,15 +99,33 @@
 #include "Vfp32_div_comb.h"
 #include "Vfp32_div_comb___024root.h"
 #include "Vfp32_div_comb_fp32_div_comb.h"
+#ifdef TB_LANES
+#include "Vfp32_div_comb_xN.h"
+#endif
+#ifdef TB_LOCKSTEP
+#include "Vfp32_div_comb_ref.h"
+#endif
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
-#include <ctime>
 #include <iomanip>
 #include <iostream>
-#include <random>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <verilated.h>
+#include "fp32_host_ref.h"
+#include "fp32_ref_model.h"
+#include "tb_bench.h"
+#include "tb_common.h"
+#include "tb_coverage.h"
+#include "tb_hard_cases.h"
+#include "tb_metamorphic.h"
+#include "tb_mismatch.h"
+#include "tb_shrink.h"
 // SoftFloat reference library
 extern "C" {
 #include "softfloat.h"
@@ -57,185 +135,1266 @@ extern "C" {
  * @brief Test configuration constants
  */
 namespace TestConfig {
-  // Test execution parameters
-  static constexpr int TOTAL_STRATIFIED_TESTS = 60000000;  // Total random test vectors
-  static constexpr int SYSTEMATIC_SUBNORM_STEP = 0x00001111;  // Step size for subnormal tests
-  static constexpr int BOUNDARY_TEST_RANGE = 0x10000;  // Range for boundary tests around 1.0
+  // Test execution parameters (vector counts and weights live in DEFAULT_SETTINGS)
+  static constexpr const char* DEFAULT_SETTINGS = "div_tests.cfg";  // Settings file read at startup
+  static constexpr int REF_BATCH = 4096;  // Vectors per pipeline block in the random phase
+  static constexpr int BENCH_VECTORS = 1 << 16;  // Vectors per region and stage in --bench mode
+  static constexpr int BENCH_REPEATS = 5;  // Best-of-N timing repeats in --bench mode
+  static constexpr uint64_t EXP_BAND_STREAM = 0x62616e64;  // Seed offset of the exponent-band vectors
+  static constexpr uint64_t META_STREAM = 0x6d657461;      // Seed offset of the metamorphic variants
+  static constexpr uint64_t VALIDATION_SEED = 0x76616c69;  // Stream of the backend validation vectors
+}
+
+/**
+ * @brief Run-time test settings (settings file, then command-line overrides)
+ */
+struct TestSettings {
+  uint64_t random_tests = 0;    // Stratified random test vectors
+  uint64_t validation_tests = 0;  // Backend-vs-SoftFloat vectors before a fast backend is used
+  uint64_t subnorm_step = 0;    // Step size for systematic subnormal dividends
+  uint64_t boundary_range = 0;  // Operand pairs in the boundary test around 1.0
+  uint64_t hard_tests = 0;      // Constructed hard-to-round operand pairs
+  uint64_t band_tests = 0;      // Operand pairs solved into the exponent bands
+  uint64_t metamorphic = 0;     // Metamorphic variants per random vector (0 = off)
+  std::string corner_file;      // Corner-case operand pairs
+  uint64_t adapt_epoch = 0;     // Random vectors between weight updates in --adaptive mode
+};
+
+// Coverage path bins (first dimension of make_div_coverage()), in bin order
+enum CoveragePath {
+  PATH_SPECIAL, PATH_NORMAL, PATH_NORMAL_CARRY, PATH_OVERFLOW,
+  PATH_DEEP_UNDERFLOW, PATH_SUBNORMAL, PATH_SUBNORMAL_CARRY
+};
+static const char* const PATH_NAMES[] = {
+  "special", "normal", "normal_carry", "overflow", "deep_underflow", "subnormal", "subnormal_carry"
+};
+
+/**
+ * @brief Bit pattern of sign, biased exponent and fraction
+ */
+static uint32_t fp32_bits(uint32_t sign, uint32_t exp, uint32_t frac) {
+  return (sign & 0x80000000u) | (exp << 23) | (frac & 0x7fffff);
+}
+
+/**
+ * @brief Quotients a few ulps below a power of two
+ *
+ * Aimed at the rounding carry into the exponent. A quotient of two 24-bit
+ * significands is never within half an ulp below a power of two, so the only
+ * carry is the subnormal tie 0xffffff / 0x800000 * 2^-127 rounding up to the
+ * minimum normal (8'd1). Results are placed at that edge half of the time,
+ * otherwise at the overflow edge or in any binade.
+ */
+static void gen_carry_edge(tb::VectorRng& rng, uint32_t& a_bits, uint32_t& b_bits) {
+  uint32_t pick = rng.below(4);
+  // Biased exponent of the (just below 2^(er - 126)) result
+  int er = pick < 2 ? 0 : pick == 2 ? 254 : static_cast<int>(rng.below(280)) - 25;
+  int lo = std::max(1, er - 126), hi = std::min(254, er + 127);
+  int ea = lo + static_cast<int>(rng.below(hi - lo + 1));
+  a_bits = fp32_bits(rng.next(), ea, 0x7fffff - rng.below(4));
+  b_bits = fp32_bits(rng.next(), ea - er + 127, rng.below(4));
+}
+
+/**
+ * @brief Quotients from 26 binades below the minimum normal up to it
+ *
+ * Aimed at the deep-underflow flush (exp_sum <= -24), its boundary and the
+ * subnormal path.
+ */
+static void gen_underflow_edge(tb::VectorRng& rng, uint32_t& a_bits, uint32_t& b_bits) {
+  uint32_t exp_a = 1 + rng.below(100);
+  uint32_t exp_b = exp_a + 126 + rng.below(28);  // result exponent exp_a - exp_b + 127 in [-26, 1]
+  a_bits = fp32_bits(rng.next(), exp_a, rng.next());
+  b_bits = fp32_bits(rng.next(), exp_b, rng.next());
+}
+
+/**
+ * @brief Exact quotients: 12-bit divisor and quotient significands
+ *
+ * The 23/24-bit product is the dividend, so a / b is exact in the normal
+ * path; results are placed near the subnormal range half of the time, where
+ * shifting them out gives exact subnormals and exact ties, and otherwise
+ * anywhere up to the overflow range.
+ */
+static void gen_exact(tb::VectorRng& rng, uint32_t& a_bits, uint32_t& b_bits) {
+  uint32_t mb = 0x800 | (rng.next() & 0x7ff);
+  uint32_t mq = 0x800 | (rng.next() & 0x7ff);
+  uint32_t ma = mb * mq;                    // in [2^22, 2^24)
+  int carry = ma >> 23;                     // product significand in [2, 4)
+  if (!carry) ma <<= 1;
+  // Biased result exponent, then a dividend exponent keeping both operands normal
+  int er = (rng.next() & 1) ? static_cast<int>(rng.below(32)) - 30 : 2 + static_cast<int>(rng.below(255));
+  int lo = std::max(1, er - 126 + carry), hi = std::min(254, er + 127 + carry);
+  int ea = lo + static_cast<int>(rng.below(hi - lo + 1));
+  a_bits = fp32_bits(rng.next(), ea, ma);
+  b_bits = fp32_bits(rng.next(), ea - er + 127 - carry, mb << 12);
+}
+
+static bool aims_carry_edge(const unsigned* v) {
+  return v[0] == PATH_SUBNORMAL_CARRY || v[0] == PATH_OVERFLOW;
+}
+static bool aims_underflow_edge(const unsigned* v) {
+  return v[0] == PATH_DEEP_UNDERFLOW || v[0] == PATH_SUBNORMAL || v[0] == PATH_SUBNORMAL_CARRY;
+}
+static bool aims_exact(const unsigned* v) {
+  return v[0] != PATH_SPECIAL && v[2] % 2 == 0;  // no sticky: exact results and exact ties
+}
+
+/**
+ * @brief Result-exponent band of the exponent-band phase
+ *
+ * Bounds are values of the RTL's exp_sum, the biased result exponent before
+ * rounding: 255 and above overflow, -24 and below flush to zero, and
+ * 1 - exp_sum is the gradual-underflow shift.
+ */
+struct ExponentBand {
+  const char* name;
+  int lo, hi;               // exp_sum range, inclusive
+};
+
+static const ExponentBand exponent_bands[] = {
+  {"overflow", 250, 258},        // top binades and overflow by up to 4 binades
+  {"underflow_cutoff", -28, -20}, // both sides of the exp_sum <= -24 flush
+  {"subnormal_shift", -23, 1}     // every shift S = 1 - exp_sum, up to the minimum normal
+};
+static constexpr size_t NUM_EXPONENT_BANDS = sizeof(exponent_bands) / sizeof(exponent_bands[0]);
+
+/**
+ * @brief Operands with random significands whose quotient has exp_sum == target
+ *
+ * The RTL computes exp_sum = ea - eb + 127 - (ma < mb), with ea, eb the
+ * exponents after normalizing subnormal operands. One operand in four is
+ * subnormal, fixing its exponent; the other exponent is solved for. When
+ * that exponent is out of range the pair falls back to normal operands,
+ * which reach every target in [-126, 379].
+ */
+static void gen_exp_band(tb::VectorRng& rng, int target, uint32_t& a_bits, uint32_t& b_bits) {
+  uint32_t pick = rng.below(8);
+  uint32_t frac_a = rng.next() & 0x7fffff, frac_b = rng.next() & 0x7fffff;
+  uint32_t sign_a = rng.next(), sign_b = rng.next();
+  for (int subnormal = pick < 2; ; subnormal = 0) {
+    bool sub_a = subnormal && pick == 0 && frac_a, sub_b = subnormal && pick == 1 && frac_b;
+    // Normalized significand and exponent of each operand
+    uint32_t ma = 0x800000 | frac_a, mb = 0x800000 | frac_b;
+    int ea = 1, eb = 1;
+    if (sub_a) for (ma = frac_a; !(ma & 0x800000); ma <<= 1) --ea;
+    if (sub_b) for (mb = frac_b; !(mb & 0x800000); mb <<= 1) --eb;
+    int d = target - 127 + (ma < mb);  // ea - eb
+    if (sub_a) {
+      eb = ea - d;
+    } else if (sub_b) {
+      ea = eb + d;
+    } else {
+      int lo = std::max(1, 1 - d), hi = std::min(254, 254 - d);
+      eb = lo + static_cast<int>(rng.below(hi - lo + 1));
+      ea = eb + d;
+    }
+    if ((!sub_a && (ea < 1 || ea > 254)) || (!sub_b && (eb < 1 || eb > 254))) continue;
+    a_bits = fp32_bits(sign_a, sub_a ? 0 : ea, frac_a);
+    b_bits = fp32_bits(sign_b, sub_b ? 0 : eb, frac_b);
+    return;
+  }
+}
+
+/**
+ * @brief Vector `index` of the exponent-band phase
+ *
+ * The band is exponent_bands[index % NUM_EXPONENT_BANDS]; successive passes
+ * over the bands step through its exp_sum values.
+ * @return The target exp_sum
+ */
+static int exp_band_vector(uint64_t seed, uint64_t index, uint32_t& a_bits, uint32_t& b_bits) {
+  const ExponentBand& band = exponent_bands[index % NUM_EXPONENT_BANDS];
+  int target = band.lo + static_cast<int>((index / NUM_EXPONENT_BANDS) % (band.hi - band.lo + 1));
+  tb::VectorRng rng(seed ^ TestConfig::EXP_BAND_STREAM, index);
+  gen_exp_band(rng, target, a_bits, b_bits);
+  return target;
+}
+
+/**
+ * @brief Operand region for stratified random testing and per-region benchmarks
+ *
+ * The FP32 space is divided into regions with different sampling weights.
+ * Weights come from the settings file (regions it does not name get 0).
+ * Directed targets are regions with their own operand generator instead of
+ * a bit-pattern range, and the coverage bins they are built to reach; their
+ * weight is normally 0 and raised by --adaptive.
+ */
+struct TestRegion {
+  uint32_t start, end;      // IEEE-754 bit pattern range
+  const char* name;         // Region description
+  int weight;               // Relative sampling weight
+  void (*generate)(tb::VectorRng&, uint32_t&, uint32_t&) = nullptr;  // directed target generator
+  bool (*aims)(const unsigned* bin_values) = nullptr;                // bins the target aims at
+};
+
+static TestRegion regions[] = {
+  // Positive ranges
+  {0x00000000, 0x00800000, "subnormals", 0},
+  {0x00800000, 0x34000000, "small_normals", 0},
+  {0x34000000, 0x3f000000, "medium_normals", 0},
+  {0x3f000000, 0x40800000, "near_one", 0},
+  {0x40800000, 0x7f000000, "large_normals", 0},
+  {0x7f000000, 0x7f800000, "near_overflow", 0},
+  {0x7f800000, 0x7fffffff, "special_values", 0},
   
-  // Test region weights for stratified random testing
-  static constexpr int WEIGHT_SUBNORMALS = 10;
-  static constexpr int WEIGHT_SMALL_NORMALS = 8; 
-  static constexpr int WEIGHT_MEDIUM_NORMALS = 5;
-  static constexpr int WEIGHT_NEAR_ONE = 15;
-  static constexpr int WEIGHT_LARGE_NORMALS = 8;
-  static constexpr int WEIGHT_NEAR_OVERFLOW = 10;
-  static constexpr int WEIGHT_SPECIAL_VALUES = 12;
+  // Negative ranges (symmetric to positive)
+  {0x80000000, 0x80800000, "neg_subnormals", 0},
+  {0x80800000, 0xb4000000, "neg_small_normals", 0},
+  {0xb4000000, 0xbf000000, "neg_medium_normals", 0},
+  {0xbf000000, 0xc0800000, "neg_near_one", 0},
+  {0xc0800000, 0xff000000, "neg_large_normals", 0},
+  {0xff000000, 0xff800000, "neg_near_overflow", 0},
+  {0xff800000, 0xffffffff, "neg_special_values", 0},
+
+  // Directed targets
+  {0, 0, "carry_edge", 0, gen_carry_edge, aims_carry_edge},
+  {0, 0, "underflow_edge", 0, gen_underflow_edge, aims_underflow_edge},
+  {0, 0, "exact", 0, gen_exact, aims_exact}
+};
+static constexpr size_t NUM_REGIONS = sizeof(regions) / sizeof(regions[0]);
+
+// Total weight and alias table for stratified sampling (rebuilt by
+// build_region_table() once the weights are set)
+static int total_weight = 0;
+static tb::AliasTable region_table;
+
+static void build_region_table() {
+  std::vector<uint64_t> weights;
+  total_weight = 0;
+  for (const auto& region : regions) {
+    weights.push_back(region.weight);
+    total_weight += region.weight;
+  }
+  if (total_weight) region_table.build(weights);
+}
+
+/**
+ * @brief Set the sampling weight of the region called `name`
+ */
+static bool set_region_weight(const std::string& name, const std::string& value) {
+  uint64_t weight;
+  if (!tb::parse_count(value, weight) || weight > 1000000) return false;
+  for (auto& region : regions) {
+    if (name == region.name) {
+      region.weight = static_cast<int>(weight);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Apply one "key value..." setting; relative file names resolve against `origin`
+ *
+ * Shared by the settings file and the command-line overrides, so both
+ * accept the same keys and values.
+ */
+static bool apply_setting(TestSettings& settings, const std::vector<std::string>& e, const std::string& origin) {
+  if (e[0] == "corner_file" && e.size() == 2) {
+    settings.corner_file = tb::resolve_relative(origin, e[1]);
+    return true;
+  }
+  if (e[0] == "random_tests" && e.size() == 2)   return tb::parse_count(e[1], settings.random_tests);
+  if (e[0] == "validation_tests" && e.size() == 2) return tb::parse_count(e[1], settings.validation_tests);
+  if (e[0] == "hard_tests" && e.size() == 2)     return tb::parse_count(e[1], settings.hard_tests);
+  if (e[0] == "band_tests" && e.size() == 2)     return tb::parse_count(e[1], settings.band_tests);
+  if (e[0] == "metamorphic" && e.size() == 2)    return tb::parse_count(e[1], settings.metamorphic);
+  if (e[0] == "subnorm_step" && e.size() == 2)   return tb::parse_count(e[1], settings.subnorm_step) && settings.subnorm_step > 0;
+  if (e[0] == "boundary_range" && e.size() == 2) {
+    return tb::parse_count(e[1], settings.boundary_range) && settings.boundary_range <= 0x3f800000;
+  }
+  if (e[0] == "weight" && e.size() == 3)         return set_region_weight(e[1], e[2]);
+  if (e[0] == "adapt_epoch" && e.size() == 2)    return tb::parse_count(e[1], settings.adapt_epoch) && settings.adapt_epoch > 0;
+  return false;
+}
+
+/**
+ * @brief Load the settings file, then apply the command-line overrides
+ * @return false (after reporting the bad entry) on error
+ */
+static bool load_test_settings(const std::string& path, const std::vector<std::vector<std::string>>& overrides,
+                               TestSettings& settings) {
+  std::vector<std::vector<std::string>> entries;
+  if (!tb::load_settings(path, entries)) {
+    std::cout << "ERROR: cannot read test settings " << path
+              << " (run from the repository root or pass --config FILE)" << std::endl;
+    return false;
+  }
+  for (const auto& e : entries) {
+    if (!apply_setting(settings, e, path)) {
+      std::cout << "ERROR: bad entry '" << e[0] << (e.size() > 1 ? " " + e[1] : "") << "' in " << path << std::endl;
+      return false;
+    }
+  }
+  for (const auto& e : overrides) {
+    if (!apply_setting(settings, e, "")) {
+      std::cout << "ERROR: bad command-line value for " << e[0] << std::endl;
+      return false;
+    }
+  }
+
+  build_region_table();
+  if (total_weight == 0 || settings.subnorm_step == 0 || settings.corner_file.empty()) {
+    std::cout << "ERROR: " << path << " must set corner_file, subnorm_step and at least one weight" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Operands of random vector `index` drawn from `region`
+ *
+ * Range regions draw the dividend from the region and, for one vector in
+ * three, the divisor too; otherwise the divisor is any bit pattern.
+ */
+static void region_vector(tb::VectorRng& rng, const TestRegion& region, uint64_t index,
+                          uint32_t& a_bits, uint32_t& b_bits) {
+  if (region.generate) {
+    region.generate(rng, a_bits, b_bits);
+    return;
+  }
+  uint32_t range = region.end - region.start;
+  a_bits = region.start + rng.below(range);
+  b_bits = index % 3 == 0 ? region.start + rng.below(range) : rng.next();
+}
+
+/**
+ * @brief Operands of stratified random vector `index` from its stream `rng`
+ *
+ * The region comes from the alias table (exact weights, no search), and
+ * bounded draws are unbiased, so every operand depends only on (seed, index)
+ * and the region weights. The index of the region drawn is stored in
+ * `source` when given.
+ */
+static void random_vector(tb::VectorRng& rng, uint64_t index, uint32_t& a_bits, uint32_t& b_bits,
+                          unsigned* source = nullptr) {
+  size_t r = region_table.pick(rng);
+  if (source) *source = static_cast<unsigned>(r);
+  region_vector(rng, regions[r], index, a_bits, b_bits);
+}
+
+static void random_vector(uint64_t seed, uint64_t index, uint32_t& a_bits, uint32_t& b_bits,
+                          unsigned* source = nullptr) {
+  tb::VectorRng rng(seed, index);
+  random_vector(rng, index, a_bits, b_bits, source);
 }
 
+/**
+ * @brief Random vectors first .. first + n - 1 (n <= REF_BATCH) of `seed`
+ *
+ * The stream keys of the whole block are derived in one vectorizable loop;
+ * any worker can generate any block from its first index alone.
+ */
+static void random_block(uint64_t seed, uint64_t first, size_t n, uint32_t* a_bits, uint32_t* b_bits,
+                         unsigned* source) {
+  uint64_t keys[TestConfig::REF_BATCH];
+  tb::VectorRng::keys(seed, first, n, keys);
+  for (size_t i = 0; i < n; ++i) {
+    tb::VectorRng rng(keys[i]);
+    random_vector(rng, first + i, a_bits[i], b_bits[i], &source[i]);
+  }
+}
+
+// Weights of the current --adaptive epoch as --weight options (empty otherwise)
+static std::string replay_weights;
+
+// --keep-going: mismatch classes of the whole run (nullptr: stop at the first mismatch)
+static tb::MismatchClusters* mismatches = nullptr;
+
+/**
+ * @brief Options that regenerate one random vector (`extra`: further options)
+ */
+static std::string replay_args(uint64_t seed, uint64_t index, const std::string& extra = "") {
+  std::ostringstream args;
+  args << "--replay 0x" << std::hex << seed << std::dec << ":" << index << replay_weights << extra;
+  return args.str();
+}
+
+/**
+ * @brief Failure corpus: "a b [expected flags actual flags source]" per line
+ */
+static const char* DEFAULT_CORPUS = "div_corpus.txt";
+static tb::FailureCorpus failure_corpus("div", 2);
+
 /**
  * @brief Global test execution time counter
  */
-int time_counter = 0;
+uint64_t time_counter = 0;
+
+/**
+ * @brief Reference implementation used by compare_with_softfloat
+ */
+enum class RefBackend { SoftFloat, Model, Host };
+static RefBackend reference_backend = RefBackend::SoftFloat;
+
+static const char* backend_name(RefBackend backend) {
+  switch (backend) {
+    case RefBackend::Model: return "native model";
+    case RefBackend::Host:  return "host FPU + SoftFloat fallback";
+    default:                return "SoftFloat";
+  }
+}
+
+/**
+ * @brief SoftFloat f32_div with its exception flags
+ */
+static fp32_ref::Result softfloat_div(uint32_t a_bits, uint32_t b_bits) {
+  softfloat_exceptionFlags = 0;
+  float32_t a_sf, b_sf;
+  a_sf.v = a_bits;
+  b_sf.v = b_bits;
+  float32_t r_sf = f32_div(a_sf, b_sf);
+  return {r_sf.v, static_cast<uint8_t>(softfloat_exceptionFlags)};
+}
+
+/**
+ * @brief Reference results for n operand pairs with the selected backend
+ */
+static void reference_div_batch(RefBackend backend, const uint32_t* a, const uint32_t* b,
+                                fp32_ref::Result* out, size_t n) {
+  switch (backend) {
+    case RefBackend::Host:
+      fp32_host::div_batch(a, b, out, n, softfloat_div);
+      break;
+    case RefBackend::Model:
+      for (size_t i = 0; i < n; ++i) out[i] = fp32_ref::div(a[i], b[i]);
+      break;
+    default:
+      for (size_t i = 0; i < n; ++i) out[i] = softfloat_div(a[i], b[i]);
+      break;
+  }
+}
+
+/**
+ * @brief Check a fast reference backend against SoftFloat before trusting it as oracle
+ *
+ * Half the vectors use independent random operands (special values, overflow
+ * and underflow), half use operands with nearby exponents so most quotients
+ * land in the normal and gradual-underflow rounding paths.
+ */
+static bool validate_reference_backend(RefBackend backend, unsigned jobs, uint64_t total) {
+  tb::ShardResult result = tb::run_sharded(jobs, total,
+      [&](unsigned, uint64_t begin, uint64_t end, std::atomic<bool>& stop) {
+    tb::ShardResult shard;
+    uint32_t block_a[TestConfig::REF_BATCH], block_b[TestConfig::REF_BATCH];
+    fp32_ref::Result block_ref[TestConfig::REF_BATCH];
+    for (uint64_t block = begin; block < end && !stop.load(std::memory_order_relaxed);
+         block += TestConfig::REF_BATCH) {
+      size_t n = static_cast<size_t>(std::min<uint64_t>(TestConfig::REF_BATCH, end - block));
+      for (size_t i = 0; i < n; ++i) {
+        tb::VectorRng rng(TestConfig::VALIDATION_SEED, block + i);
+        block_a[i] = rng.next();
+        block_b[i] = rng.next();
+        if ((block + i) & 1) {
+          uint32_t exp_b = (((block_a[i] >> 23) & 0xff) + (block_b[i] >> 26) - 0x20) & 0xff;
+          block_b[i] = (block_b[i] & 0x807fffff) | (exp_b << 23);
+        }
+      }
+      reference_div_batch(backend, block_a, block_b, block_ref, n);
+      for (size_t i = 0; i < n; ++i) {
+        fp32_ref::Result ref = softfloat_div(block_a[i], block_b[i]);
+        if (block_ref[i].y != ref.y || block_ref[i].flags != ref.flags) {
+          std::lock_guard<std::mutex> lock(tb::output_mutex());
+          std::cout << "[" << backend_name(backend) << "] mismatch: a=0x" << std::hex << std::setw(8)
+                    << std::setfill('0') << block_a[i] << " b=0x" << std::setw(8) << block_b[i]
+                    << " backend=0x" << std::setw(8) << block_ref[i].y << " flags=0x" << (int)block_ref[i].flags
+                    << " softfloat=0x" << std::setw(8) << ref.y << " flags=0x" << (int)ref.flags
+                    << std::dec << std::endl;
+          shard.failed = true;
+          return shard;
+        }
+        shard.tested++;
+      }
+    }
+    return shard;
+  });
+  return !result.failed;
+}
+
+/**
+ * @brief Evaluate one vector on a DUT instance and compare against SoftFloat
+ *
+ * Each worker passes its own DUT; SoftFloat flags are thread-local, so this
+ * is safe to call concurrently. Reports are serialized on tb::output_mutex().
+ */
+static bool compare_with_softfloat(Vfp32_div_comb* dut, uint32_t a_bits, uint32_t b_bits,
+                                   const char* test_name = "", bool verbose_on_fail = false,
+                                   bool show_debug = false, bool always_verbose = false,
+                                   const fp32_ref::Result* precomputed = nullptr) {
+  // Set inputs and evaluate RTL
+  dut->a = a_bits;
+  dut->b = b_bits;
+  dut->eval();
+  
+  // Get RTL result and flags
+  union { uint32_t u; float f; } rtl_result;
+  rtl_result.u = dut->y;
+  uint8_t rtl_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) |
+                      (dut->exc_overflow << 2) | (dut->exc_underflow << 1) |
+                      (dut->exc_inexact);
+  
+  // Reference result: precomputed by a batch backend, or computed here
+  fp32_ref::Result ref;
+  if (precomputed) {
+    ref = *precomputed;
+  } else {
+    reference_div_batch(reference_backend, &a_bits, &b_bits, &ref, 1);
+  }
+  float32_t math_result_sf;
+  math_result_sf.v = ref.y;
+  uint8_t math_flags = ref.flags;
+  
+  // ULP calculation for detailed analysis
+  uint32_t ulp_diff = 0;
+  bool is_nan_case = std::isnan(*(float*)&rtl_result.u) && std::isnan(*(float*)&math_result_sf.v);
+  if (!is_nan_case) {
+    if (rtl_result.u == math_result_sf.v) {
+      ulp_diff = 0;
+    } else if ((rtl_result.u == 0x00000000 && math_result_sf.v == 0x80000000) ||
+               (rtl_result.u == 0x80000000 && math_result_sf.v == 0x00000000)) {
+      ulp_diff = 0;  // +0 and -0 are equivalent
+    } else {
+      // Simple absolute difference for same-sign numbers
+      if ((rtl_result.u ^ math_result_sf.v) & 0x80000000) {
+        // Different signs - sum the magnitudes
+        ulp_diff = (rtl_result.u & 0x7FFFFFFF) + (math_result_sf.v & 0x7FFFFFFF);
+      } else {
+        // Same sign - absolute difference  
+        ulp_diff = (rtl_result.u > math_result_sf.v) ? (rtl_result.u - math_result_sf.v) : (math_result_sf.v - rtl_result.u);
+      }
+    }
+  }
+  
+  // Check for mismatch (NaN: compare bit patterns exactly including payload)
+  bool result_match = is_nan_case ? (rtl_result.u == math_result_sf.v) : (ulp_diff == 0);
+  bool flags_match = (rtl_flags == math_flags);
+  bool overall_pass = result_match && flags_match;
+  
+  // Report results if requested (--keep-going prints only the first mismatches)
+  bool report_mismatch = !overall_pass && (!mismatches || mismatches->claim_report());
+  if (report_mismatch || always_verbose) {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    union { uint32_t u; float f; } a_conv, b_conv;
+    a_conv.u = a_bits;
+    b_conv.u = b_bits;
+    
+    std::cout << (strlen(test_name) > 0 ? std::string("[") + test_name + "] " : "")
+              << "a=" << a_conv.f << "(0x" << std::hex << std::setw(8) << std::setfill('0') << a_bits << ") "
+              << "b=" << b_conv.f << "(0x" << std::setw(8) << std::setfill('0') << b_bits << ") "
+              << std::dec << "RTL=" << rtl_result.f << "(0x" << std::hex << std::setw(8) << std::setfill('0') << rtl_result.u << ") "
+              << "Math=" << math_result_sf.v << "(0x" << std::setw(8) << std::setfill('0') << math_result_sf.v << ") "
+              << std::dec << "ulp_diff=" << ulp_diff << " "
+              << (result_match ? "PASS" : "FAIL");
+    
+    // Show flag comparison
+    std::cout << " |FLAG=" << (flags_match ? "PASS" : "FAIL") 
+              << " RTL_flags=0x" << std::hex << (int)rtl_flags 
+              << " Math_flags=0x" << (int)math_flags << std::dec;
+    
+    // Show debug signals if requested
+    if (show_debug) {
+      std::cout << " |dbg_final=0x" << std::hex << std::setw(6) << std::setfill('0') 
+                << dut->fp32_div_comb->dbg_quotient_final << std::dec
+                << " guard=" << static_cast<int>(dut->fp32_div_comb->dbg_guard_bit)
+                << " sticky=" << static_cast<int>(dut->fp32_div_comb->dbg_sticky_bit)
+                << " raw_div=0x" << std::hex << std::setw(14) << std::setfill('0')
+                << static_cast<unsigned long long>(dut->fp32_div_comb->dbg_raw_div_full)
+                << " q25=0x" << std::setw(7) << std::setfill('0') << dut->fp32_div_comb->dbg_quotient_25b 
+                << " mantissa=0x" << std::setw(7) << std::setfill('0') << dut->fp32_div_comb->dbg_mantissa_work
+                << std::dec << " lz=" << static_cast<int>(dut->fp32_div_comb->dbg_leading_zeros) 
+                << " norm=0x" << std::hex << std::setw(13) << std::setfill('0')
+                << static_cast<unsigned long long>(dut->fp32_div_comb->dbg_quotient_norm) 
+                << std::dec << " round_up=" << static_cast<int>(dut->fp32_div_comb->dbg_round_up);
+    }
+    
+    std::cout << std::endl;
+  } else if (verbose_on_fail && report_mismatch) {
+    // Simple failure report for non-verbose modes
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    union { uint32_t u; float f; } a_conv, b_conv;
+    a_conv.u = a_bits;
+    b_conv.u = b_bits;
+    
+    std::cout << "[" << test_name << " FAIL] "
+              << "a=" << a_conv.f << "(0x" << std::hex << a_bits << ") "
+              << "b=" << b_conv.f << "(0x" << b_bits << ") "
+              << "RTL=" << rtl_result.f << "(0x" << rtl_result.u << ") "
+              << "Math=" << math_result_sf.v << "(0x" << math_result_sf.v << ") "
+              << "RTL_flags=0x" << (int)rtl_flags << " "
+              << "Math_flags=0x" << (int)math_flags << std::dec << std::endl;
+  }
+  
+  return overall_pass;
+}
+
+/**
+ * @brief Append a failing vector to the corpus, with the result `dut` holds for it
+ *
+ * Call right after the failing evaluation; the expected result is SoftFloat's.
+ */
+static void record_failure(Vfp32_div_comb* dut, uint32_t a_bits, uint32_t b_bits, const char* source) {
+  fp32_ref::Result expected = softfloat_div(a_bits, b_bits);
+  unsigned rtl_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) | (dut->exc_overflow << 2) |
+                       (dut->exc_underflow << 1) | dut->exc_inexact;
+  failure_corpus.append({a_bits, b_bits}, expected.y, expected.flags, dut->y, rtl_flags, source);
+}
+
+/**
+ * @brief Coverage group over the divider debug signals
+ *
+ * path: special (operand exceptions), normal (with or without a rounding
+ * carry into the exponent), overflow, deep underflow (exp_sum <= -24, flushed
+ * to zero), subnormal (gradual underflow, with or without a carry to the
+ * minimum normal 8'd1); lz_q: 23 plus the dividend pre-alignment, i.e. the
+ * leading zeros of the unaligned 50-bit quotient; gs: guard
+ * and sticky (OR of all lower bits, round bit included) of the path that
+ * rounds; round_up: that path's rounding increment; flags: highest raised flag.
+ */
+static tb::Coverage make_div_coverage() {
+  tb::Coverage coverage("fp32_div_comb path x lz_q x gs x round_up x flags", {
+      {"path", {PATH_NAMES, PATH_NAMES + sizeof(PATH_NAMES) / sizeof(PATH_NAMES[0])}},
+      {"lz_q", {"23", "24", "other"}},
+      {"gs", {"g0s0", "g0s1", "g1s0", "g1s1"}},
+      {"round_up", {"0", "1"}},
+      {"flags", {"none", "inexact", "underflow", "overflow", "divzero", "invalid"}}});
+  coverage.mark_impossible([](const unsigned* v) {
+    // Special path: datapath debug signals stay 0, no rounding flags
+    if (v[0] == PATH_SPECIAL) return v[1] != 2 || v[2] != 0 || v[3] != 0 || (v[4] >= 1 && v[4] <= 3);
+    // divzero and invalid come from the special path only
+    if (v[4] >= 4) return true;
+    // Normalized mantissas give a quotient in (0.5, 2), i.e. a 26- or 27-bit
+    // raw quotient: lz_q is 24 or 23
+    if (v[1] == 2) return true;
+    // Round to nearest even: up when guard and sticky, never without guard
+    if (v[2] == 3 ? v[3] == 0 : v[2] < 2 && v[3] == 1) return true;
+    // A 25-bit quotient of two 24-bit mantissas is never exact, so the paths
+    // rounding the normalized quotient see no ties
+    if (v[0] < PATH_SUBNORMAL && v[2] == 2) return true;
+    bool exact = v[2] == 0;
+    switch (v[0]) {
+      case PATH_NORMAL:          return exact ? v[4] != 0 : v[4] != 1;
+      // ma / mb is at least 1 / (2 * mb) > 2^-25 below a power of two: it
+      // never rounds up into the next binade
+      case PATH_NORMAL_CARRY:    return true;
+      case PATH_OVERFLOW:        return v[4] != 3;
+      case PATH_DEEP_UNDERFLOW:  return v[4] != 2;  // flushed to zero even when exact
+      case PATH_SUBNORMAL:       return exact ? v[4] != 0 : v[4] != 2;
+      // Only (2^24 - 1) / 2^23 * 2^-127, an exact tie below 2^-126, rounds up
+      // to the minimum normal; it is tiny, so underflow is raised
+      default:                   return v[1] != 0 || v[2] != 2 || v[3] != 1 || v[4] != 2;
+    }
+  });
+  return coverage;
+}
+
+/**
+ * @brief Datapath branch the vector last evaluated on `dut` took
+ */
+static CoveragePath div_coverage_path(Vfp32_div_comb* dut) {
+  const auto* m = dut->fp32_div_comb;
+  // Branch order of the RTL: overflow, deep underflow, subnormal, normal
+  int exp_sum = static_cast<int16_t>(m->dbg_exp_sum << 6) >> 6;  // signed 10-bit
+  int norm1 = (m->dbg_mantissa_work >> 24) & 1;
+  return !m->dbg_normal_path ? PATH_SPECIAL
+       : exp_sum + norm1 > 254 ? PATH_OVERFLOW
+       : exp_sum <= -24 ? PATH_DEEP_UNDERFLOW
+       : m->dbg_subnormal_path ? (m->dbg_round_up_s && m->dbg_mant_rounded == 0 ? PATH_SUBNORMAL_CARRY
+                                                                                : PATH_SUBNORMAL)
+       : norm1 ? PATH_NORMAL_CARRY : PATH_NORMAL;
+}
+
+/**
+ * @brief Coverage bin of the vector last evaluated on `dut`
+ */
+static size_t div_coverage_bin(const tb::Coverage& coverage, Vfp32_div_comb* dut) {
+  const auto* m = dut->fp32_div_comb;
+  unsigned path = div_coverage_path(dut);
+  bool subnormal = path >= PATH_SUBNORMAL;
+  unsigned guard = subnormal ? m->dbg_guard_s : m->dbg_guard_bit;
+  unsigned sticky = subnormal ? m->dbg_round_s | m->dbg_sticky_s
+                              : static_cast<unsigned>((m->dbg_quotient_norm >> 24) & 1) | m->dbg_sticky_bit;
+  unsigned round_up = subnormal ? m->dbg_round_up_s : m->dbg_round_up;
+  unsigned lz = m->dbg_leading_zeros == 23 ? 0 : m->dbg_leading_zeros == 24 ? 1 : 2;
+  unsigned flags = dut->exc_invalid ? 5 : dut->exc_divzero ? 4 : dut->exc_overflow ? 3
+                 : dut->exc_underflow ? 2 : dut->exc_inexact ? 1 : 0;
+  return coverage.bin({path, lz, guard * 2 + sticky, round_up, flags});
+}
+
+/**
+ * @brief The vector (a_bits, b_bits) as `dut` evaluated it, against SoftFloat
+ */
+static tb::MismatchClusters::Vector div_mismatch(Vfp32_div_comb* dut, uint32_t a_bits, uint32_t b_bits,
+                                                 const std::string& origin = "") {
+  fp32_ref::Result expected = softfloat_div(a_bits, b_bits);
+  unsigned rtl_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) | (dut->exc_overflow << 2) |
+                       (dut->exc_underflow << 1) | dut->exc_inexact;
+  return {{a_bits, b_bits}, expected.y, dut->y, expected.flags, rtl_flags, origin};
+}
+
+/**
+ * @brief Shrink the failing vector (a_bits, b_bits) and add the result to the corpus
+ *
+ * Candidates are kept while they still mismatch and fall into the same
+ * mismatch class (see tb_shrink.h). `dut` holds (a_bits, b_bits) again
+ * afterwards.
+ * Nothing is shrunk or recorded if the DUT matches SoftFloat on the vector.
+ */
+static void minimize_failure(Vfp32_div_comb* dut, uint32_t a_bits, uint32_t b_bits, const char* source) {
+  // Class key of (a, b), or "" if the DUT gets it right
+  auto mismatch_class = [dut](uint32_t a, uint32_t b) {
+    dut->a = a;
+    dut->b = b;
+    dut->eval();
+    tb::MismatchClusters::Vector v = div_mismatch(dut, a, b);
+    if (v.actual == v.expected && v.actual_flags == v.expected_flags) return std::string();
+    return tb::MismatchClusters::classify(PATH_NAMES[div_coverage_path(dut)], v);
+  };
+  std::string target = mismatch_class(a_bits, b_bits);
+  // Flagged by an oracle other than SoftFloat (--ref, metamorphic variant)
+  // while the DUT matches SoftFloat: there is no class to shrink within
+  if (target.empty()) return;
+  std::vector<uint32_t> ops = {a_bits, b_bits};
+  unsigned evals = tb::shrink_operands(ops, [&](const std::vector<uint32_t>& c) {
+    return mismatch_class(c[0], c[1]) == target;
+  });
+  if (ops[0] != a_bits || ops[1] != b_bits) {
+    mismatch_class(ops[0], ops[1]);
+    record_failure(dut, ops[0], ops[1], (std::string(source) + "/min").c_str());
+  }
+  {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    std::cout << "Minimized: " << std::hex << std::setfill('0') << "0x" << std::setw(8) << a_bits << " 0x"
+              << std::setw(8) << b_bits << " -> 0x" << std::setw(8) << ops[0] << " 0x" << std::setw(8) << ops[1]
+              << std::dec << " (" << evals << " evaluations)" << std::endl;
+  }
+  mismatch_class(a_bits, b_bits);
+}
+
+/**
+ * @brief Handle the mismatch `dut` just produced for (a_bits, b_bits)
+ *
+ * Without --keep-going the vector goes to the corpus (if `to_corpus`), the
+ * replay options of a random vector are printed and the run stops. With
+ * --keep-going it joins its mismatch class; only class representatives go
+ * to the corpus. Either way the vector is then minimized, and the minimized
+ * vector goes to the corpus too.
+ * @return true to continue with the next vector
+ */
+static bool on_mismatch(Vfp32_div_comb* dut, uint32_t a_bits, uint32_t b_bits, const char* source,
+                        bool to_corpus = true, const std::string& replay = "") {
+  bool representative = true;
+  if (mismatches) {
+    representative = mismatches->add(PATH_NAMES[div_coverage_path(dut)],
+                                     div_mismatch(dut, a_bits, b_bits,
+                                                  replay.empty() ? source : std::string(source) + " " + replay));
+  } else if (!replay.empty()) {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    std::cout << "Replay: " << replay << std::endl;
+  }
+  if (representative) {
+    if (to_corpus) record_failure(dut, a_bits, b_bits, source);
+    minimize_failure(dut, a_bits, b_bits, source);
+  }
+  return mismatches != nullptr;
+}
+
+/**
+ * @brief Check `count` metamorphic variants of random vector `index` against its reference result
+ *
+ * Variants depend only on (seed, index), so --replay checks the same ones.
+ * @return false if a variant mismatched and the run should stop
+ */
+static bool check_variants(Vfp32_div_comb* dut, uint64_t seed, uint64_t index, uint32_t a_bits, uint32_t b_bits,
+                           const fp32_ref::Result& ref, uint64_t count, bool verbose, uint64_t& checked) {
+  tb::VectorRng rng(seed ^ TestConfig::META_STREAM, index);
+  tb::Variant v;
+  for (uint64_t i = 0; i < count; ++i) {
+    if (!tb::div_variant(rng, a_bits, b_bits, ref, v)) break;
+    std::string test_id = "META " + std::to_string(index) + " " + v.transform;
+    if (!compare_with_softfloat(dut, v.a, v.b, test_id.c_str(), false, true, verbose, &v.expected) &&
+        !on_mismatch(dut, v.a, v.b, "metamorphic", true,
+                     replay_args(seed, index, " --metamorphic " + std::to_string(count)))) {
+      return false;
+    }
+    checked++;
+  }
+  return true;
+}
+
+// Sum of the region weights set by --adaptive
+static constexpr int ADAPT_SCALE = 1000;
+
+/**
+ * @brief Re-weight the regions from the coverage reached so far (--adaptive)
+ *
+ * `base` holds the configured weights. Prints the new weights and keeps
+ * them as --weight options for replay hints.
+ */
+static void adapt_region_weights(const tb::Coverage& coverage, const tb::AdaptiveWeights& feedback,
+                                 const std::vector<int>& base) {
+  std::vector<std::vector<unsigned>> bin_values(coverage.bins());
+  for (size_t b = 0; b < coverage.bins(); ++b) bin_values[b] = coverage.values(b);
+  std::vector<int> weights = feedback.update(coverage, base, ADAPT_SCALE, [&](size_t source, size_t bin) {
+    return regions[source].aims && regions[source].aims(bin_values[bin].data());
+  });
+
+  replay_weights.clear();
+  std::cout << "[ADAPT] weights:";
+  for (size_t r = 0; r < NUM_REGIONS; ++r) {
+    regions[r].weight = weights[r];
+    replay_weights += std::string(" --weight ") + regions[r].name + "=" + std::to_string(weights[r]);
+    if (weights[r]) std::cout << " " << regions[r].name << "=" << weights[r];
+  }
+  std::cout << std::endl;
+  build_region_table();
+}
+
+#ifdef TB_LANES
+static_assert(TB_LANES > 2 && TB_LANES <= 32, "TB_LANES must be 3..32 (wide data ports, scalar flag ports)");
+
+/**
+ * @brief Evaluate n <= TB_LANES vectors with a single eval() of the multi-lane model
+ */
+static void eval_lanes(Vfp32_div_comb_xN* xdut, const uint32_t* a, const uint32_t* b, size_t n,
+                       uint32_t* y, uint8_t* flags) {
+  for (size_t l = 0; l < TB_LANES; ++l) {
+    xdut->a[l] = l < n ? a[l] : 0x3f800000;  // idle lanes divide 1/1
+    xdut->b[l] = l < n ? b[l] : 0x3f800000;
+  }
+  xdut->eval();
+  for (size_t l = 0; l < n; ++l) {
+    y[l] = xdut->y[l];
+    flags[l] = (((xdut->exc_invalid >> l) & 1) << 4) | (((xdut->exc_divzero >> l) & 1) << 3) |
+               (((xdut->exc_overflow >> l) & 1) << 2) | (((xdut->exc_underflow >> l) & 1) << 1) |
+               ((xdut->exc_inexact >> l) & 1);
+  }
+}
+#endif
+
+/**
+ * @brief Full check of random vector `index`, whose block result (y, flags) was not bit-identical to ref
+ *
+ * The vector is replayed on the scalar DUT through compare_with_softfloat,
+ * which applies the full pass criteria (+0 matches -0) and prints the
+ * detailed report. In lane builds the replay must also reproduce the lane's
+ * output; a lane that disagrees with the scalar DUT always stops the run.
+ * Mismatches go through on_mismatch().
+ * @return false if the run should stop
+ */
+static bool check_random_vector(Vfp32_div_comb* dut, uint32_t a, uint32_t b, const fp32_ref::Result& ref,
+                                uint32_t y, uint8_t flags, uint64_t seed, uint64_t index, bool verbose) {
+  std::string test_id = "Time:" + std::to_string(index);
+  if (!compare_with_softfloat(dut, a, b, test_id.c_str(), false, true, verbose, &ref)) {
+    return on_mismatch(dut, a, b, "random", true, replay_args(seed, index));
+  }
+#ifdef TB_LANES
+  uint8_t dut_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) | (dut->exc_overflow << 2) |
+                      (dut->exc_underflow << 1) | dut->exc_inexact;
+  if (y != dut->y || flags != dut_flags) {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    std::cout << "[" << test_id << "] lane disagrees with scalar DUT: lane=0x" << std::hex << std::setw(8)
+              << std::setfill('0') << y << " flags=0x" << (int)flags
+              << " scalar=0x" << std::setw(8) << dut->y << " flags=0x" << (int)dut_flags << std::dec << std::endl;
+    std::cout << "Replay: " << replay_args(seed, index) << std::endl;
+    record_failure(dut, a, b, "random");
+    return false;
+  }
+#else
+  (void)y;
+  (void)flags;
+#endif
+  return true;
+}
+
+#ifdef TB_LOCKSTEP
+/**
+ * @brief Drive the DUT and the reference RTL with (a_bits, b_bits) and compare them bit for bit
+ * @return false (after reporting both results) if y or any exception flag differs
+ */
+static bool compare_lockstep(Vfp32_div_comb* dut, Vfp32_div_comb_ref* ref, uint32_t a_bits, uint32_t b_bits,
+                             const char* phase, uint64_t index) {
+  dut->a = ref->a = a_bits;
+  dut->b = ref->b = b_bits;
+  dut->eval();
+  ref->eval();
+  unsigned dut_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) | (dut->exc_overflow << 2) |
+                       (dut->exc_underflow << 1) | dut->exc_inexact;
+  unsigned ref_flags = (ref->exc_invalid << 4) | (ref->exc_divzero << 3) | (ref->exc_overflow << 2) |
+                       (ref->exc_underflow << 1) | ref->exc_inexact;
+  if (dut->y == ref->y && dut_flags == ref_flags) return true;
+  std::lock_guard<std::mutex> lock(tb::output_mutex());
+  std::cout << "[LOCKSTEP " << phase << " " << index << "] a=0x" << std::hex << std::setfill('0') << std::setw(8)
+            << a_bits << " b=0x" << std::setw(8) << b_bits << " rtl=0x" << std::setw(8) << dut->y << " flags=0x"
+            << dut_flags << " ref_rtl=0x" << std::setw(8) << ref->y << " flags=0x" << ref_flags << std::dec
+            << std::endl;
+  return false;
+}
+
+/**
+ * @brief RTL-vs-RTL lockstep run (--lockstep, lockstep builds only)
+ *
+ * Compares the DUT with the reference RTL (Vfp32_div_comb_ref, a trusted
+ * revision verilated next to it, see `make div_lockstep`) on the corner
+ * cases and the hard-to-round, exponent-band and stratified random vectors
+ * of `seed`, on `jobs` workers and without SoftFloat in the loop. The first
+ * disagreement stops the run and goes to the failure corpus, so a normal
+ * run then tells which side is wrong.
+ * @return process exit code
+ */
+static int run_lockstep(unsigned jobs, uint64_t seed, const TestSettings& settings) {
+  std::vector<std::vector<uint32_t>> corner_cases;
+  if (!tb::load_vectors(settings.corner_file, 2, corner_cases)) {
+    std::cout << "ERROR: cannot read corner cases from " << settings.corner_file << std::endl;
+    return 1;
+  }
+  std::cout << "=== Lockstep: fp32_div_comb vs reference RTL ===" << std::endl;
+  std::cout << "Worker threads: " << jobs << std::endl;
+  std::cout << "Seed: 0x" << std::hex << seed << std::dec << std::endl;
+
+  enum { CORNER, HARD, BAND, RANDOM };
+  struct Phase { const char* name; uint64_t count; };
+  const Phase phases[] = {{"corner", corner_cases.size()}, {"hard", settings.hard_tests},
+                          {"band", settings.band_tests}, {"random", settings.random_tests}};
+  uint64_t total = 0;
+  for (int p = CORNER; p <= RANDOM; ++p) {
+    tb::Stopwatch timer;
+    tb::ShardResult result = tb::run_sharded(jobs, phases[p].count,
+        [&](unsigned, uint64_t begin, uint64_t end, std::atomic<bool>& stop) {
+      tb::ShardResult shard;
+      std::unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+      std::unique_ptr<Vfp32_div_comb> wdut(new Vfp32_div_comb(contextp.get()));
+      std::unique_ptr<Vfp32_div_comb_ref> wref(new Vfp32_div_comb_ref(contextp.get()));
+      for (uint64_t i = begin; i < end; ++i) {
+        // Poll for failures in other workers
+        if (i % TestConfig::REF_BATCH == 0 && stop.load(std::memory_order_relaxed)) break;
+        uint32_t a_bits, b_bits;
+        if (p == CORNER) {
+          a_bits = corner_cases[i][0];
+          b_bits = corner_cases[i][1];
+        } else if (p == HARD) {
+          tb::VectorRng rng(~seed, i);
+          if (!tb::hard_div_operands(rng, a_bits, b_bits)) continue;
+        } else if (p == BAND) {
+          exp_band_vector(seed, i, a_bits, b_bits);
+        } else {
+          random_vector(seed, i, a_bits, b_bits);
+        }
+        if (!compare_lockstep(wdut.get(), wref.get(), a_bits, b_bits, phases[p].name, i)) {
+          record_failure(wdut.get(), a_bits, b_bits, "lockstep");
+          shard.failed = true;
+          break;
+        }
+        shard.tested++;
+      }
+      wref->final();
+      wdut->final();
+      return shard;
+    });
+    double seconds = timer.seconds();
+    total += result.tested;
+    std::cout << "[LOCKSTEP] " << phases[p].name << ": " << result.tested << " vectors, " << std::fixed
+              << std::setprecision(0) << (result.tested / (seconds > 0 ? seconds : 1)) << " vectors/s"
+              << std::endl;
+    if (result.failed) {
+      std::cout << "Lockstep FAILED: the DUT and the reference RTL disagree" << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "Lockstep passed: " << total << " vectors bit-identical to the reference RTL" << std::endl;
+  return 0;
+}
+#endif
+
+/**
+ * @brief Per-region, per-stage throughput benchmark (--bench)
+ *
+ * Stages, in ns/vector over BENCH_VECTORS operand pairs drawn from each region:
+ * gen (operand generation), eval (dut->eval() with output reads), eval_xN in
+ * lane builds (one wrapper eval() per TB_LANES vectors), ref_softfloat,
+ * ref_model and ref_host (reference backends), and check (compare_with_softfloat
+ * with a precomputed reference: eval plus comparison; comparison cost is
+ * check - eval).
+ * @return process exit code (1 = output not written or baseline regression)
+ */
+static int run_bench(const std::string& out_path, const std::string& baseline_path, double tolerance_pct) {
+  std::cout << "=== Throughput benchmark ===" << std::endl;
+  std::unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+  std::unique_ptr<Vfp32_div_comb> bdut(new Vfp32_div_comb(contextp.get()));
+#ifdef TB_LANES
+  std::unique_ptr<Vfp32_div_comb_xN> xdut(new Vfp32_div_comb_xN(contextp.get()));
+#endif
+  const size_t n = TestConfig::BENCH_VECTORS;
+  std::vector<uint32_t> a(n), b(n);
+  std::vector<fp32_ref::Result> ref(n);
+  volatile uint32_t sink = 0;  // keeps timed loops from being optimized away
+  tb::BenchReport report("div");
+
+  for (const auto& region : regions) {
+    double gen_ns = tb::time_ns_per_vector(n, TestConfig::BENCH_REPEATS, [&] {
+      for (size_t i = 0; i < n; ++i) {
+        tb::VectorRng rng(0xbe7c0000u, i);
+        region_vector(rng, region, 3 * i, a[i], b[i]);  // both operands from the region
+      }
+    });
+    double eval_ns = tb::time_ns_per_vector(n, TestConfig::BENCH_REPEATS, [&] {
+      uint32_t acc = 0;
+      for (size_t i = 0; i < n; ++i) {
+        bdut->a = a[i];
+        bdut->b = b[i];
+        bdut->eval();
+        acc += bdut->y + bdut->exc_inexact;
+      }
+      sink = sink + acc;
+    });
+#ifdef TB_LANES
+    double eval_xn_ns = tb::time_ns_per_vector(n, TestConfig::BENCH_REPEATS, [&] {
+      uint32_t acc = 0;
+      for (size_t i = 0; i < n; i += TB_LANES) {
+        for (size_t l = 0; l < TB_LANES; ++l) {
+          xdut->a[l] = a[(i + l) % n];
+          xdut->b[l] = b[(i + l) % n];
+        }
+        xdut->eval();
+        acc += xdut->y[0] + xdut->exc_inexact;
+      }
+      sink = sink + acc;
+    });
+#endif
+    double sf_ns = tb::time_ns_per_vector(n, TestConfig::BENCH_REPEATS, [&] {
+      reference_div_batch(RefBackend::SoftFloat, a.data(), b.data(), ref.data(), n);
+    });
+    double model_ns = tb::time_ns_per_vector(n, TestConfig::BENCH_REPEATS, [&] {
+      reference_div_batch(RefBackend::Model, a.data(), b.data(), ref.data(), n);
+    });
+    double host_ns = tb::time_ns_per_vector(n, TestConfig::BENCH_REPEATS, [&] {
+      reference_div_batch(RefBackend::Host, a.data(), b.data(), ref.data(), n);
+    });
+    bool all_pass = true;
+    double check_ns = tb::time_ns_per_vector(n, TestConfig::BENCH_REPEATS, [&] {
+      for (size_t i = 0; i < n; ++i) {
+        all_pass &= compare_with_softfloat(bdut.get(), a[i], b[i], "BENCH", false, false, false, &ref[i]);
+      }
+    });
+    if (!all_pass) {
+      std::cout << "ERROR: mismatch while benchmarking region " << region.name << std::endl;
+      return 1;
+    }
+
+    report.add(region.name, "gen", gen_ns);
+    report.add(region.name, "eval", eval_ns);
+#ifdef TB_LANES
+    report.add(region.name, "eval_x" + std::to_string(TB_LANES), eval_xn_ns);
+#endif
+    report.add(region.name, "ref_softfloat", sf_ns);
+    report.add(region.name, "ref_model", model_ns);
+    report.add(region.name, "ref_host", host_ns);
+    report.add(region.name, "check", check_ns);
+  }
+  bdut->final();
+#ifdef TB_LANES
+  xdut->final();
+#endif
+
+  if (!report.write(out_path)) {
+    std::cout << "ERROR: cannot write " << out_path << std::endl;
+    return 1;
+  }
+  std::cout << "Results appended to " << out_path << std::endl;
+  if (!baseline_path.empty() && !report.check_baseline(baseline_path, tolerance_pct)) return 1;
+  return 0;
+}
 
 int main(int argc, char **argv) {
-  // Parse command line arguments for verbose mode
+  // Parse command line arguments
   bool verbose = false;
+  long requested_jobs = 1;
+  RefBackend random_backend = RefBackend::Model;
+  bool seed_given = false;
+  uint64_t seed = 0;
+  bool replay = false;
+  uint64_t replay_index = 0;
+  bool bench = false;
+  std::string bench_out = "bench_output.txt";
+  std::string bench_baseline;
+  double bench_tolerance = 25.0;
+  std::string corpus_path = DEFAULT_CORPUS;
+  std::string settings_path = TestConfig::DEFAULT_SETTINGS;
+  std::vector<std::vector<std::string>> overrides;  // settings given on the command line
+  bool coverage_enabled = true;
+  std::string coverage_out;
+  bool adaptive = false;
+  bool keep_going = false;
+  bool lockstep = false;
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
       verbose = true;
+    } else if (strcmp(argv[i], "--ref") == 0 && i + 1 < argc) {
+      ++i;
+      if (strcmp(argv[i], "softfloat") == 0) {
+        random_backend = RefBackend::SoftFloat;
+      } else if (strcmp(argv[i], "model") == 0) {
+        random_backend = RefBackend::Model;
+      } else if (strcmp(argv[i], "host") == 0) {
+        random_backend = RefBackend::Host;
+      } else {
+        std::cout << "ERROR: unknown reference backend '" << argv[i] << "'" << std::endl;
+        return 1;
+      }
+    } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+      requested_jobs = strtol(argv[++i], nullptr, 0);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = strtoull(argv[++i], nullptr, 0);
+      seed_given = true;
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      if (!tb::parse_replay(argv[++i], seed, replay_index)) {
+        std::cout << "ERROR: --replay expects seed:index, got '" << argv[i] << "'" << std::endl;
+        return 1;
+      }
+      replay = true;
+    } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+      corpus_path = argv[++i];
+    } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+      settings_path = argv[++i];
+    } else if (strcmp(argv[i], "--corners") == 0 && i + 1 < argc) {
+      overrides.push_back({"corner_file", argv[++i]});
+    } else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--random-tests") == 0) && i + 1 < argc) {
+      overrides.push_back({"random_tests", argv[++i]});
+    } else if (strcmp(argv[i], "--validation-tests") == 0 && i + 1 < argc) {
+      overrides.push_back({"validation_tests", argv[++i]});
+    } else if (strcmp(argv[i], "--subnorm-step") == 0 && i + 1 < argc) {
+      overrides.push_back({"subnorm_step", argv[++i]});
+    } else if (strcmp(argv[i], "--boundary-range") == 0 && i + 1 < argc) {
+      overrides.push_back({"boundary_range", argv[++i]});
+    } else if (strcmp(argv[i], "--hard-tests") == 0 && i + 1 < argc) {
+      overrides.push_back({"hard_tests", argv[++i]});
+    } else if (strcmp(argv[i], "--band-tests") == 0 && i + 1 < argc) {
+      overrides.push_back({"band_tests", argv[++i]});
+    } else if (strcmp(argv[i], "--metamorphic") == 0 && i + 1 < argc) {
+      overrides.push_back({"metamorphic", argv[++i]});
+    } else if (strcmp(argv[i], "--weight") == 0 && i + 1 < argc) {
+      std::string arg = argv[++i];
+      size_t eq = arg.find('=');
+      overrides.push_back({"weight", arg.substr(0, eq), eq == std::string::npos ? "" : arg.substr(eq + 1)});
+    } else if (strcmp(argv[i], "--no-coverage") == 0) {
+      coverage_enabled = false;
+    } else if (strcmp(argv[i], "--coverage-out") == 0 && i + 1 < argc) {
+      coverage_out = argv[++i];
+    } else if (strcmp(argv[i], "--adaptive") == 0) {
+      adaptive = true;
+    } else if (strcmp(argv[i], "--keep-going") == 0) {
+      keep_going = true;
+    } else if (strcmp(argv[i], "--lockstep") == 0) {
+      lockstep = true;
+    } else if (strcmp(argv[i], "--adapt-epoch") == 0 && i + 1 < argc) {
+      overrides.push_back({"adapt_epoch", argv[++i]});
+    } else if (strcmp(argv[i], "--bench") == 0) {
+      bench = true;
+    } else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) {
+      bench_out = argv[++i];
+    } else if (strcmp(argv[i], "--bench-baseline") == 0 && i + 1 < argc) {
+      bench_baseline = argv[++i];
+    } else if (strcmp(argv[i], "--bench-tolerance") == 0 && i + 1 < argc) {
+      bench_tolerance = strtod(argv[++i], nullptr);
     }
   }
+  unsigned jobs = tb::resolve_jobs(requested_jobs);
+  if (jobs > 1 && !tb::softfloat_thread_safe()) {
+    std::cout << "WARNING: SoftFloat not built with THREAD_LOCAL; running single-threaded" << std::endl;
+    jobs = 1;
+  }
   
+  if (bench) {
+    Verilated::commandArgs(argc, argv);
+    return run_bench(bench_out, bench_baseline, bench_tolerance);
+  }
+
+  // Test counts and region weights: settings file, then command-line overrides
+  TestSettings settings;
+  if (!load_test_settings(settings_path, overrides, settings)) return 1;
+  if (adaptive && (!coverage_enabled || settings.adapt_epoch == 0)) {
+    std::cout << "ERROR: --adaptive needs coverage and an adapt_epoch setting" << std::endl;
+    return 1;
+  }
+
+  // Replay regenerates one random vector from its seed and index and checks
+  // it against SoftFloat with the full debug report
+  if (replay) {
+    Verilated::commandArgs(argc, argv);
+    std::unique_ptr<Vfp32_div_comb> rdut(new Vfp32_div_comb());
+    uint32_t a_bits, b_bits;
+    random_vector(seed, replay_index, a_bits, b_bits);
+    std::ostringstream test_id;
+    test_id << "REPLAY 0x" << std::hex << seed << std::dec << ":" << replay_index;
+    bool pass = compare_with_softfloat(rdut.get(), a_bits, b_bits, test_id.str().c_str(), false, true, true);
+    uint64_t variants = 0;
+    if (pass && settings.metamorphic) {
+      pass = check_variants(rdut.get(), seed, replay_index, a_bits, b_bits, softfloat_div(a_bits, b_bits),
+                            settings.metamorphic, true, variants);
+    }
+    rdut->final();
+    return pass ? 0 : 1;
+  }
+
+  // Seed for the stratified random phase; printed so any vector can be replayed
+  if (!seed_given) seed = tb::random_seed();
+
+  // Lockstep mode compares the DUT with the reference RTL instead of SoftFloat
+  if (lockstep) {
+#ifdef TB_LOCKSTEP
+    Verilated::commandArgs(argc, argv);
+    if (!corpus_path.empty()) failure_corpus.load(corpus_path);
+    return run_lockstep(jobs, seed, settings);
+#else
+    std::cout << "ERROR: --lockstep needs a lockstep build (make div_lockstep)" << std::endl;
+    return 1;
+#endif
+  }
+
   std::cout << "=== IEEE-754 FP32 Combinational Divider Test Suite ===" << std::endl;
-  std::cout << "Target test vectors: " << TestConfig::TOTAL_STRATIFIED_TESTS << std::endl;
+  std::cout << "Settings: " << settings_path << std::endl;
+  std::cout << "Target test vectors: " << settings.random_tests << std::endl;
+  if (adaptive) std::cout << "Adaptive weights: every " << settings.adapt_epoch << " vectors" << std::endl;
+  if (keep_going) std::cout << "Keep going: mismatches are classified and summarized at the end" << std::endl;
   std::cout << "Verbose mode: " << (verbose ? "ON" : "OFF") << std::endl;
+  std::cout << "Seed: 0x" << std::hex << seed << std::dec << std::endl;
   std::cout << "=======================================================" << std::endl;
-  
-  // Initialize random seed for reproducible yet varied testing
-  srand(static_cast<unsigned>(time(nullptr)));
+
+  tb::MismatchClusters mismatch_classes;
+  if (keep_going) mismatches = &mismatch_classes;
 
   Verilated::commandArgs(argc, argv);
   Vfp32_div_comb *dut = new Vfp32_div_comb();
 
+  // Coverage of the corner-case, systematic and random phases
+  tb::Coverage coverage = make_div_coverage();
+
   // Test execution tracking variables
+  int num_corpus = 0;       // Failure corpus replay count
   int num_cc = 0;           // Corner case test count
   int systematic_tests = 0; // Systematic test count
+  uint64_t hard_tests = 0;  // Hard-to-round test count
+  uint64_t band_tests = 0;  // Exponent-band test count
   
-  // Stratified random testing configuration
-  // Divide FP32 space into regions with different sampling weights
-  struct TestRegion {
-    uint32_t start, end;      // IEEE-754 bit pattern range
-    const char* name;         // Region description
-    int weight;               // Relative sampling weight
-  };
-  
-  TestRegion regions[] = {
-    // Positive ranges
-    {0x00000000, 0x00800000, "subnormals", TestConfig::WEIGHT_SUBNORMALS},
-    {0x00800000, 0x34000000, "small_normals", TestConfig::WEIGHT_SMALL_NORMALS},
-    {0x34000000, 0x3f000000, "medium_normals", TestConfig::WEIGHT_MEDIUM_NORMALS},
-    {0x3f000000, 0x40800000, "near_one", TestConfig::WEIGHT_NEAR_ONE},
-    {0x40800000, 0x7f000000, "large_normals", TestConfig::WEIGHT_LARGE_NORMALS},
-    {0x7f000000, 0x7f800000, "near_overflow", TestConfig::WEIGHT_NEAR_OVERFLOW},
-    {0x7f800000, 0x7fffffff, "special_values", TestConfig::WEIGHT_SPECIAL_VALUES},
-    
-    // Negative ranges (symmetric to positive)
-    {0x80000000, 0x80800000, "neg_subnormals", TestConfig::WEIGHT_SUBNORMALS},
-    {0x80800000, 0xb4000000, "neg_small_normals", TestConfig::WEIGHT_SMALL_NORMALS},
-    {0xb4000000, 0xbf000000, "neg_medium_normals", TestConfig::WEIGHT_MEDIUM_NORMALS},
-    {0xbf000000, 0xc0800000, "neg_near_one", TestConfig::WEIGHT_NEAR_ONE},
-    {0xc0800000, 0xff000000, "neg_large_normals", TestConfig::WEIGHT_LARGE_NORMALS},
-    {0xff000000, 0xff800000, "neg_near_overflow", TestConfig::WEIGHT_NEAR_OVERFLOW},
-    {0xff800000, 0xffffffff, "neg_special_values", TestConfig::WEIGHT_SPECIAL_VALUES}
-  };
-  
-  // Calculate total weight for stratified sampling
-  int total_weight = 0;
-  for (auto& region : regions) total_weight += region.weight;
-
-  // === Enhanced common SoftFloat comparison function ===
-  auto compare_with_softfloat = [&](uint32_t a_bits, uint32_t b_bits, const char* test_name = "", 
-                                     bool verbose_on_fail = false, bool show_debug = false, 
-                                     bool always_verbose = false) -> bool {
-    // Set inputs and evaluate RTL
-    dut->a = a_bits;
-    dut->b = b_bits;
-    dut->eval();
-    
-    // Get RTL result and flags
-    union { uint32_t u; float f; } rtl_result;
-    rtl_result.u = dut->y;
-    uint8_t rtl_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) |
-                        (dut->exc_overflow << 2) | (dut->exc_underflow << 1) |
-                        (dut->exc_inexact);
-    
-    // Compute SoftFloat reference
-    softfloat_exceptionFlags = 0;
-    float32_t a_sf, b_sf;
-    a_sf.v = a_bits;
-    b_sf.v = b_bits;
-    float32_t math_result_sf = f32_div(a_sf, b_sf);
-    uint8_t math_flags = softfloat_exceptionFlags;
-    
-    // ULP calculation for detailed analysis
-    uint32_t ulp_diff = 0;
-    bool is_nan_case = std::isnan(*(float*)&rtl_result.u) && std::isnan(*(float*)&math_result_sf.v);
-    if (!is_nan_case) {
-      if (rtl_result.u == math_result_sf.v) {
-        ulp_diff = 0;
-      } else if ((rtl_result.u == 0x00000000 && math_result_sf.v == 0x80000000) ||
-                 (rtl_result.u == 0x80000000 && math_result_sf.v == 0x00000000)) {
-        ulp_diff = 0;  // +0 and -0 are equivalent
-      } else {
-        // Simple absolute difference for same-sign numbers
-        if ((rtl_result.u ^ math_result_sf.v) & 0x80000000) {
-          // Different signs - sum the magnitudes
-          ulp_diff = (rtl_result.u & 0x7FFFFFFF) + (math_result_sf.v & 0x7FFFFFFF);
-        } else {
-          // Same sign - absolute difference  
-          ulp_diff = (rtl_result.u > math_result_sf.v) ? (rtl_result.u - math_result_sf.v) : (math_result_sf.v - rtl_result.u);
-        }
-      }
+  // === Failure corpus replay ===
+  // Vectors that failed in earlier runs are checked first, so a regression
+  // they caught is reported before any other phase runs
+  if (!corpus_path.empty()) {
+    if (!failure_corpus.load(corpus_path)) {
+      std::cout << "WARNING: skipped malformed lines in " << corpus_path << std::endl;
     }
-    
-    // Check for mismatch (NaN: compare bit patterns exactly including payload)
-    bool result_match = is_nan_case ? (rtl_result.u == math_result_sf.v) : (ulp_diff == 0);
-    bool flags_match = (rtl_flags == math_flags);
-    bool overall_pass = result_match && flags_match;
-    
-    // Report results if requested
-    if (!overall_pass || always_verbose) {
-      union { uint32_t u; float f; } a_conv, b_conv;
-      a_conv.u = a_bits;
-      b_conv.u = b_bits;
-      
-      std::cout << (strlen(test_name) > 0 ? std::string("[") + test_name + "] " : "")
-                << "a=" << a_conv.f << "(0x" << std::hex << std::setw(8) << std::setfill('0') << a_bits << ") "
-                << "b=" << b_conv.f << "(0x" << std::setw(8) << std::setfill('0') << b_bits << ") "
-                << std::dec << "RTL=" << rtl_result.f << "(0x" << std::hex << std::setw(8) << std::setfill('0') << rtl_result.u << ") "
-                << "Math=" << math_result_sf.v << "(0x" << std::setw(8) << std::setfill('0') << math_result_sf.v << ") "
-                << std::dec << "ulp_diff=" << ulp_diff << " "
-                << (result_match ? "PASS" : "FAIL");
-      
-      // Show flag comparison
-      std::cout << " |FLAG=" << (flags_match ? "PASS" : "FAIL") 
-                << " RTL_flags=0x" << std::hex << (int)rtl_flags 
-                << " Math_flags=0x" << (int)math_flags << std::dec;
-      
-      // Show debug signals if requested
-      if (show_debug) {
-        std::cout << " |dbg_final=0x" << std::hex << std::setw(6) << std::setfill('0') 
-                  << dut->fp32_div_comb->dbg_quotient_final << std::dec
-                  << " guard=" << static_cast<int>(dut->fp32_div_comb->dbg_guard_bit)
-                  << " sticky=" << static_cast<int>(dut->fp32_div_comb->dbg_sticky_bit)
-                  << " raw_div=0x" << std::hex << std::setw(14) << std::setfill('0')
-                  << static_cast<unsigned long long>(dut->fp32_div_comb->dbg_raw_div_full)
-                  << " q25=0x" << std::setw(7) << std::setfill('0') << dut->fp32_div_comb->dbg_quotient_25b 
-                  << " mantissa=0x" << std::setw(7) << std::setfill('0') << dut->fp32_div_comb->dbg_mantissa_work
-                  << std::dec << " lz=" << static_cast<int>(dut->fp32_div_comb->dbg_leading_zeros) 
-                  << " norm=0x" << std::hex << std::setw(13) << std::setfill('0')
-                  << static_cast<unsigned long long>(dut->fp32_div_comb->dbg_quotient_norm) 
-                  << std::dec << " round_up=" << static_cast<int>(dut->fp32_div_comb->dbg_round_up);
+    num_corpus = static_cast<int>(failure_corpus.entries().size());
+    std::cout << "=== Failure corpus replay (" << num_corpus << " vectors from " << corpus_path << ") ===" << std::endl;
+    for (int i = 0; i < num_corpus; ++i) {
+      const tb::FailureCorpus::Operands& ops = failure_corpus.entries()[i];
+      if (!compare_with_softfloat(dut, ops[0], ops[1], ("CORPUS " + std::to_string(i)).c_str(), true, true, verbose) &&
+          !on_mismatch(dut, ops[0], ops[1], "corpus", false)) {
+        dut->final();
+        delete dut;
+        return 1;
       }
-      
-      std::cout << std::endl;
-    } else if (verbose_on_fail && !overall_pass) {
-      // Simple failure report for non-verbose modes
-      union { uint32_t u; float f; } a_conv, b_conv;
-      a_conv.u = a_bits;
-      b_conv.u = b_bits;
-      
-      std::cout << "[" << test_name << " FAIL] "
-                << "a=" << a_conv.f << "(0x" << std::hex << a_bits << ") "
-                << "b=" << b_conv.f << "(0x" << b_bits << ") "
-                << "RTL=" << rtl_result.f << "(0x" << rtl_result.u << ") "
-                << "Math=" << math_result_sf.v << "(0x" << math_result_sf.v << ") "
-                << "RTL_flags=0x" << (int)rtl_flags << " "
-                << "Math_flags=0x" << (int)math_flags << std::dec << std::endl;
     }
-    
-    return overall_pass;
-  };
+  }
 
   // === Corner-case tests ===
   {
@@ -243,137 +1402,44 @@ int main(int argc, char **argv) {
       float f;
       uint32_t u;
     } conv_a_cc, conv_b_cc;
-    static const struct {
-      uint32_t a, b;
-    } corner_cases[] = {
-        // === Basic special values ===
-        {0x00000000, 0x00000000}, // 0/0 -> NaN (invalid)
-        {0x00000000, 0x3f800000}, // 0/1 -> 0
-        {0x80000000, 0x3f800000}, // -0/1 -> -0
-        {0x3f800000, 0x00000000}, // 1/0 -> inf (divzero)
-        {0x3f800000, 0x80000000}, // 1/-0 -> -inf (divzero)
-        {0x7f800000, 0x3f800000}, // inf/1 -> inf
-        {0xff800000, 0x3f800000}, // -inf/1 -> -inf
-        {0x7f800000, 0x7f800000}, // inf/inf -> NaN (invalid)
-        {0x7f800000, 0xff800000}, // inf/-inf -> NaN (invalid)
-        {0x3f800000, 0x7f800000}, // 1/inf -> 0
-        {0x3f800000, 0xff800000}, // 1/-inf -> -0
-        {0x7fc00000, 0x3f800000}, // qNaN/1 -> qNaN
-        {0x7fa00000, 0x3f800000}, // sNaN/1 -> qNaN (invalid)
-        {0x3f800000, 0x7fc00000}, // 1/qNaN -> qNaN
-        {0x3f800000, 0x7fa00000}, // 1/sNaN -> qNaN (invalid)
-        
-        // === Subnormal boundaries ===
-        {0x00000001, 0x00000001}, // min subnormal/min subnormal -> 1.0
-        {0x00000001, 0x3f800000}, // min subnormal/1.0 -> min subnormal
-        {0x007fffff, 0x3f800000}, // max subnormal/1.0 -> max subnormal
-        {0x00800000, 0x00800000}, // min normal/min normal -> 1.0
-        {0x00800000, 0x40000000}, // min normal/2.0 -> gradual underflow
-        {0x00800001, 0x40000000}, // slightly above min normal/2.0
-        {0x007fffff, 0x40000000}, // max subnormal/2.0
-        
-        // === Overflow boundaries ===
-        {0x7f7fffff, 0x3f800000}, // max finite/1 -> max finite
-        {0x7f7fffff, 0x3f000000}, // max finite/0.5 -> inf (overflow)
-        {0x7f000000, 0x3f000000}, // large/0.5 -> overflow
-        {0x7e800000, 0x3e800000}, // boundary overflow test
-        
-        // === Exact divisions ===
-        {0x3f800000, 0x3f800000}, // 1.0/1.0 -> 1.0 (exact)
-        {0x40000000, 0x40000000}, // 2.0/2.0 -> 1.0 (exact)
-        {0x40400000, 0x40000000}, // 3.0/2.0 -> 1.5 (exact)
-        {0x40800000, 0x40000000}, // 4.0/2.0 -> 2.0 (exact)
-        {0x41200000, 0x40800000}, // 10.0/4.0 -> 2.5 (exact)
-        {0x42c80000, 0x41200000}, // 100.0/10.0 -> 10.0 (exact)
-        
-        // === Rounding-critical divisions ===
-        {0x3f800000, 0x40400000}, // 1.0/3.0 -> 0.333... (round to nearest)
-        {0x40000000, 0x40400000}, // 2.0/3.0 -> 0.666... (round to nearest)
-        {0x3f800000, 0x41200000}, // 1.0/10.0 -> 0.1 (rounding)
-        {0x3f800000, 0x40e00000}, // 1.0/7.0 -> 0.142857... (rounding)
-        {0x41200000, 0x40400000}, // 10.0/3.0 -> 3.333... (rounding)
-        
-        // === Tie-to-even rounding cases ===
-        {0x40400000, 0x48000000}, // 3.0/32768.0 -> tie case
-        {0x40a00000, 0x48800000}, // 5.0/65536.0 -> tie case
-        {0x3f800001, 0x48000000}, // slightly above 1.0/32768.0
-        {0x3f7fffff, 0x48000000}, // slightly below 1.0/32768.0
-        
-        // === Leading zero normalization edge cases ===
-        {0x3f800000, 0x4f800000}, // 1.0/very_large -> many leading zeros in quotient
-        {0x3f800000, 0x70000000}, // 1.0/extremely_large -> edge of subnormal
-        {0x38800000, 0x7f000000}, // small/large -> deep subnormal
-        {0x08000000, 0x4f800000}, // very_small/large -> deep underflow
-        
-        // === Sticky bit edge cases ===
-        {0x40000001, 0x40400000}, // 2.0000001/3.0 -> sticky bit test
-        {0x40400001, 0x40000000}, // 3.0000001/2.0 -> sticky bit test
-        {0x7f7ffffe, 0x40000000}, // near-max/2.0 -> sticky preservation
-        
-        // === Sign combinations ===
-        {0x80000000, 0x80000000}, // -0/-0 -> NaN (invalid)
-        {0xbf800000, 0x3f800000}, // -1.0/1.0 -> -1.0
-        {0x3f800000, 0xbf800000}, // 1.0/-1.0 -> -1.0
-        {0xbf800000, 0xbf800000}, // -1.0/-1.0 -> 1.0
-        {0xff800000, 0x80000000}, // -inf/-0 -> +inf (inf has priority over divzero)
-        {0x7f800000, 0x80000000}, // inf/-0 -> -inf (inf has priority over divzero)
-        
-        // === Previously observed failure cases ===
-        {0x3781fd3f, 0xf8480000}, // 1.54959e-05/-1.62259e+34 (underflow)
-        {0xaacf58b8, 0xeae1320a}, // -3.68321e-13/-1.36122e+26 (subnormal)
-        {0x96042d06, 0x5d042d06}, // -1.06771e-25/5.95267e+17
-        {0x9be34bb1, 0xe0988600}, // -3.76029e-22/-8.79238e+19
-        {0x0f8746fe, 0x514c0000}, // 1.33394e-29/5.47608e+10
-        {0x920c6be1, 0x517da98a}, // -4.43092e-28/6.80919e+10
-        {0x057e2068, 0xc4b49df2}, // 1.19490e-35/-1444.94
-        {0xa8ec1495, 0x68a45fad}, // -2.62102e-14/6.20986e+24
-        {0x325cd2c3, 0xf6209948}, // 1.28536e-08/-8.14332e+32 (exact subnormal)
-        {0x29eed5eb, 0xefbbfc00}, // 1.06064e-13/-1.16357e+29 (rounding issue: expected 0x8000028a, got 0x8000028b)
-        
-        // === Algorithm stress tests ===
-        {0x34000000, 0x7f7fffff}, // small/max -> extreme underflow
-        {0x7f7fffff, 0x34000000}, // max/small -> extreme overflow
-        {0x00800000, 0x7f7fffff}, // min_normal/max -> extreme underflow
-        {0x7f7fffff, 0x00800000}, // max/min_normal -> extreme overflow
-        {0x00000001, 0x7f7fffff}, // min_subnormal/max -> extreme underflow
-        {0x7f7fffff, 0x00000001}, // max/min_subnormal -> extreme overflow
-        
-        // === Quotient normalization edge cases ===
-        {0x3f000000, 0x3f800000}, // 0.5/1.0 -> 0.5 (no normalization)
-        {0x3e800000, 0x3f800000}, // 0.25/1.0 -> 0.25 (1 bit normalization)
-        {0x3e000000, 0x3f800000}, // 0.125/1.0 -> 0.125 (2 bit normalization)
-        {0x3d800000, 0x3f800000}, // 0.0625/1.0 -> 0.0625 (3 bit normalization)
-        
-        // === Guard/round/sticky boundary tests ===
-        {0x40000003, 0x40400000}, // guard bit boundary
-        {0x40000005, 0x40400000}, // round bit boundary  
-        {0x40000007, 0x40400000}, // sticky bit boundary
-        {0x4000000f, 0x40400000}, // multiple sticky bits
-    };
-    num_cc = sizeof(corner_cases) / sizeof(corner_cases[0]);
+    // Operand pairs are read from the corner-case file (see div_corner_cases.txt)
+    std::vector<std::vector<uint32_t>> corner_cases;
+    unsigned bad_line = 0;
+    if (!tb::load_vectors(settings.corner_file, 2, corner_cases, &bad_line)) {
+      std::cout << "ERROR: cannot read corner cases from " << settings.corner_file;
+      if (bad_line) std::cout << " (malformed line " << bad_line << ")";
+      std::cout << std::endl;
+      dut->final();
+      delete dut;
+      return 1;
+    }
+    num_cc = static_cast<int>(corner_cases.size());
     for (int i = 0; i < num_cc; ++i) {
-      if (!compare_with_softfloat(corner_cases[i].a, corner_cases[i].b, ("CASE " + std::to_string(i)).c_str(), !verbose)) {
+      if (!compare_with_softfloat(dut, corner_cases[i][0], corner_cases[i][1], ("CASE " + std::to_string(i)).c_str(), !verbose)) {
         // On failure, provide detailed output if not in verbose mode
         if (!verbose) {
           union { uint32_t u; float f; } a_conv, b_conv;
-          a_conv.u = corner_cases[i].a;
-          b_conv.u = corner_cases[i].b;
+          a_conv.u = corner_cases[i][0];
+          b_conv.u = corner_cases[i][1];
           std::cout << "[CASE " << i << "] Failed: a=" << a_conv.f 
-                    << "(0x" << std::hex << corner_cases[i].a << ") "
-                    << "b=" << b_conv.f << "(0x" << corner_cases[i].b << ")" << std::dec << std::endl;
+                    << "(0x" << std::hex << corner_cases[i][0] << ") "
+                    << "b=" << b_conv.f << "(0x" << corner_cases[i][1] << ")" << std::dec << std::endl;
           // Re-run with verbose output for this specific case
-          compare_with_softfloat(corner_cases[i].a, corner_cases[i].b, ("CASE " + std::to_string(i)).c_str(), true);
+          compare_with_softfloat(dut, corner_cases[i][0], corner_cases[i][1], ("CASE " + std::to_string(i)).c_str(), true);
+        }
+        if (!on_mismatch(dut, corner_cases[i][0], corner_cases[i][1], "corner", false)) {
+          return 1;  // Exit on first corner case failure
         }
-        return 1;  // Exit on first corner case failure
       }
+      if (coverage_enabled) coverage.hit(div_coverage_bin(coverage, dut));
       // Verbose output for passing cases if requested
       if (verbose) {
         union { uint32_t u; float f; } a_conv, b_conv;
-        a_conv.u = corner_cases[i].a;
-        b_conv.u = corner_cases[i].b;
+        a_conv.u = corner_cases[i][0];
+        b_conv.u = corner_cases[i][1];
         std::cout << "[CASE " << i << "] PASS: a=" << a_conv.f 
-                  << "(0x" << std::hex << corner_cases[i].a << ") "
-                  << "b=" << b_conv.f << "(0x" << corner_cases[i].b << ")" << std::dec << std::endl;
+                  << "(0x" << std::hex << corner_cases[i][0] << ") "
+                  << "b=" << b_conv.f << "(0x" << corner_cases[i][1] << ")" << std::dec << std::endl;
       }
     }
     std::cout << "=== Corner-case tests done ===" << std::endl;
@@ -383,104 +1449,286 @@ int main(int argc, char **argv) {
   std::cout << "=== Systematic boundary testing ===" << std::endl;
   
   // Test all subnormal dividends with various divisors
-  for (uint32_t subnormal = 0x00000001; subnormal <= 0x007fffff; subnormal += TestConfig::SYSTEMATIC_SUBNORM_STEP) {
+  for (uint64_t step_sub = 0x00000001; step_sub <= 0x007fffff; step_sub += settings.subnorm_step) {
+    uint32_t subnormal = static_cast<uint32_t>(step_sub);
     uint32_t divisors[] = {0x3f800000, 0x40000000, 0x3f000000, 0x41200000, 0x3e800000};
     for (uint32_t divisor : divisors) {
-      if (!compare_with_softfloat(subnormal, divisor, "SYSTEMATIC", true)) {
+      if (!compare_with_softfloat(dut, subnormal, divisor, "SYSTEMATIC", true) &&
+          !on_mismatch(dut, subnormal, divisor, "systematic")) {
         return 1;  // Exit on first failure for systematic tests
       }
+      if (coverage_enabled) coverage.hit(div_coverage_bin(coverage, dut));
       systematic_tests++;
     }
   }
   
   // Test boundary transitions around 1.0
-  for (uint32_t i = 0; i < TestConfig::BOUNDARY_TEST_RANGE; ++i) {
-    uint32_t near_one_a = 0x3f800000 + i - 0x8000;  // Around 1.0
-    uint32_t near_one_b = 0x3f800000 + (i * 17) - 0x8000;  // Different pattern
-    if (!compare_with_softfloat(near_one_a, near_one_b, "BOUNDARY", true)) {
+  uint32_t boundary_half = static_cast<uint32_t>(settings.boundary_range / 2);
+  for (uint32_t i = 0; i < settings.boundary_range; ++i) {
+    uint32_t near_one_a = 0x3f800000 + i - boundary_half;  // Around 1.0
+    uint32_t near_one_b = 0x3f800000 + (i * 17) - boundary_half;  // Different pattern
+    if (!compare_with_softfloat(dut, near_one_a, near_one_b, "BOUNDARY", true) &&
+        !on_mismatch(dut, near_one_a, near_one_b, "boundary")) {
       return 1;  // Exit on first failure
     }
+    if (coverage_enabled) coverage.hit(div_coverage_bin(coverage, dut));
     systematic_tests++;
   }
   
   std::cout << "Systematic tests completed: " << systematic_tests << std::endl;
 
-  // === Improved random testing with multiple generators ===
-  std::cout << "=== Enhanced random testing ===" << std::endl;
-  
-  // Use multiple PRNG states for better coverage
-  std::random_device rd;
-  std::mt19937 gen1(rd());
-  std::mt19937 gen2(rd() + 12345);
-  std::mt19937 gen3(rd() + 67890);
-  std::uniform_int_distribution<uint32_t> dis(0, 0xFFFFFFFF);
-
-  while (time_counter < TestConfig::TOTAL_STRATIFIED_TESTS) {
-    // Select region based on weighted probability
-    int region_select = dis(gen1) % total_weight;
-    int current_weight = 0;
-    TestRegion* selected_region = nullptr;
-    
-    for (auto& region : regions) {
-      current_weight += region.weight;
-      if (region_select < current_weight) {
-        selected_region = &region;
-        break;
-      }
-    }
-    
-    // Generate values within selected region using different generators
-    uint32_t rand_bits_a, rand_bits_b;
-    if (selected_region->start == selected_region->end) {
-      rand_bits_a = selected_region->start;
-    } else {
-      uint32_t range_a = selected_region->end - selected_region->start;
-      rand_bits_a = selected_region->start + (dis(gen1) % range_a);
+  // === Hard-to-round tests ===
+  // Quotients just above or below a rounding midpoint or a representable
+  // value, normal and subnormal, always checked against SoftFloat. Drawn
+  // from the inverted seed so they do not repeat the random phase's streams.
+  std::cout << "=== Hard-to-round tests ===" << std::endl;
+  for (uint64_t i = 0; i < settings.hard_tests; ++i) {
+    tb::VectorRng rng(~seed, i);
+    uint32_t hard_a, hard_b;
+    if (!tb::hard_div_operands(rng, hard_a, hard_b)) continue;
+    std::string test_id = "HARD " + std::to_string(i);
+    if (!compare_with_softfloat(dut, hard_a, hard_b, test_id.c_str(), true, true, verbose) &&
+        !on_mismatch(dut, hard_a, hard_b, "hard")) {
+      return 1;
     }
-    
-    // Select different region for divisor or use full range
-    if (time_counter % 3 == 0) {
-      // Sometimes use values from same region for both operands
-      uint32_t range_b = selected_region->end - selected_region->start;
-      rand_bits_b = selected_region->start + (dis(gen2) % range_b);
-    } else {
-      // Other times use completely different generator
-      rand_bits_b = dis(gen3);
+    if (coverage_enabled) coverage.hit(div_coverage_bin(coverage, dut));
+    hard_tests++;
+  }
+  std::cout << "Hard-to-round tests completed: " << hard_tests << std::endl;
+
+  // === Exponent-band tests ===
+  // Random significands with operand exponents solved so that exp_sum lands
+  // in the overflow, flush-cutoff and gradual-underflow bands, cycling
+  // through the bands and the exp_sum values within each.
+  std::cout << "=== Exponent-band tests ===" << std::endl;
+  uint64_t band_vectors[NUM_EXPONENT_BANDS] = {}, band_on_target[NUM_EXPONENT_BANDS] = {};
+  for (uint64_t i = 0; i < settings.band_tests; ++i) {
+    uint32_t band_a, band_b;
+    int target = exp_band_vector(seed, i, band_a, band_b);
+    std::string test_id = "BAND " + std::to_string(i);
+    if (!compare_with_softfloat(dut, band_a, band_b, test_id.c_str(), true, true, verbose) &&
+        !on_mismatch(dut, band_a, band_b, "band")) {
+      return 1;
     }
-    
-    union {
-      float f;
-      uint32_t u;
-    } conv_a, conv_b;
-    conv_a.u = rand_bits_a;
-    conv_b.u = rand_bits_b;
-
-    // Use common comparison function with time counter info and debug output
-    std::string test_id = "Time:" + std::to_string(time_counter);
-    if (!compare_with_softfloat(conv_a.u, conv_b.u, test_id.c_str(), false, true, verbose)) {
-      // Exit immediately on failure for random tests
+    if (coverage_enabled) coverage.hit(div_coverage_bin(coverage, dut));
+    int exp_sum = static_cast<int16_t>(dut->fp32_div_comb->dbg_exp_sum << 6) >> 6;  // signed 10-bit
+    band_vectors[i % NUM_EXPONENT_BANDS]++;
+    band_on_target[i % NUM_EXPONENT_BANDS] += exp_sum == target;
+    band_tests++;
+  }
+  for (size_t b = 0; b < NUM_EXPONENT_BANDS && band_tests; ++b) {
+    std::cout << "  " << exponent_bands[b].name << " [" << exponent_bands[b].lo << ", " << exponent_bands[b].hi
+              << "]: " << band_vectors[b] << " vectors, " << band_on_target[b] << " at the target exp_sum" << std::endl;
+  }
+  std::cout << "Exponent-band tests completed: " << band_tests << std::endl;
+
+  // === Reference backend validation ===
+  // Corner and systematic phases always use SoftFloat; the random phase may
+  // switch to a faster backend once it has been shown to agree with SoftFloat.
+  if (random_backend != RefBackend::SoftFloat) {
+    std::cout << "=== Reference backend validation ===" << std::endl;
+    if (!validate_reference_backend(random_backend, jobs, settings.validation_tests)) {
+      std::cout << "Reference backend disagrees with SoftFloat; rerun with --ref softfloat" << std::endl;
+      dut->final();
+      delete dut;
       return 1;
     }
+    std::cout << "Backend matches SoftFloat on " << settings.validation_tests << " vectors" << std::endl;
+  }
+  reference_backend = random_backend;
+
+  // === Improved random testing with multiple generators ===
+  std::cout << "=== Enhanced random testing ===" << std::endl;
+  std::cout << "Worker threads: " << jobs << std::endl;
+  std::cout << "Reference: " << backend_name(reference_backend) << std::endl;
+#ifdef TB_LANES
+  std::cout << "Lanes per eval(): " << TB_LANES << std::endl;
+#endif
+
+  // Shard the vector index space across workers. Each worker owns its own
+  // Verilated model; vectors come from (seed, index), so only the stop flag
+  // is shared. Adaptive runs shard one epoch at a time and re-weight the
+  // regions in between; otherwise the whole phase is one epoch.
+  tb::Stopwatch random_timer;
+  std::vector<tb::Coverage> worker_coverage(jobs, make_div_coverage());
+  std::vector<uint64_t> worker_variants(jobs, 0);
+  std::vector<tb::AdaptiveWeights> worker_feedback(adaptive ? jobs : 0,
+                                                   tb::AdaptiveWeights(NUM_REGIONS, coverage.bins()));
+  std::vector<int> base_weights;
+  for (const auto& region : regions) base_weights.push_back(region.weight);
+  uint64_t epoch_len = adaptive ? settings.adapt_epoch : settings.random_tests;
+  tb::ShardResult random_result;
+  for (uint64_t epoch = 0; epoch < settings.random_tests; epoch += epoch_len) {
+    tb::ShardResult epoch_result = tb::run_sharded(jobs, std::min(epoch_len, settings.random_tests - epoch),
+        [&](unsigned worker, uint64_t begin, uint64_t end, std::atomic<bool>& stop) {
+      begin += epoch;
+      end += epoch;
+      tb::ShardResult shard;
+      tb::Coverage& wcov = worker_coverage[worker];
+      // Record the coverage bin (and, when adaptive, the source region) of the vector last evaluated on d
+      auto sample = [&](Vfp32_div_comb* d, uint64_t index, unsigned source) {
+        size_t bin = div_coverage_bin(wcov, d);
+        wcov.hit(bin, index);
+        if (adaptive) worker_feedback[worker].record(source, bin);
+      };
+      std::unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+      std::unique_ptr<Vfp32_div_comb> wdut(new Vfp32_div_comb(contextp.get()));
+#ifdef TB_LANES
+      std::unique_ptr<Vfp32_div_comb_xN> xdut(new Vfp32_div_comb_xN(contextp.get()));
+#endif
 
-    time_counter++;
+      // Block pipeline over REF_BATCH vectors: generate all operands, run all
+      // DUT evals, run all reference computations, then compare the result
+      // and flag arrays in one pass. Only mismatching indices are formatted.
+      uint32_t block_a[TestConfig::REF_BATCH], block_b[TestConfig::REF_BATCH];
+      unsigned block_src[TestConfig::REF_BATCH];
+      uint32_t block_y[TestConfig::REF_BATCH];
+      uint8_t block_flags[TestConfig::REF_BATCH];
+      fp32_ref::Result block_ref[TestConfig::REF_BATCH];
+      uint32_t block_bad[TestConfig::REF_BATCH];
+
+      for (uint64_t block = begin; block < end; block += TestConfig::REF_BATCH) {
+        // Poll for failures in other workers
+        if (stop.load(std::memory_order_relaxed)) break;
+        size_t n = static_cast<size_t>(std::min<uint64_t>(TestConfig::REF_BATCH, end - block));
+
+        random_block(seed, block, n, block_a, block_b, block_src);
+
+#ifdef TB_LANES
+        for (size_t i = 0; i < n; i += TB_LANES) {
+          eval_lanes(xdut.get(), block_a + i, block_b + i, std::min<size_t>(TB_LANES, n - i), block_y + i,
+                     block_flags + i);
+        }
+        // The wrapper has no debug ports: sample coverage on the scalar model
+        for (size_t i = 0; coverage_enabled && i < n; ++i) {
+          wdut->a = block_a[i];
+          wdut->b = block_b[i];
+          wdut->eval();
+          sample(wdut.get(), block + i, block_src[i]);
+        }
+#else
+        for (size_t i = 0; i < n; ++i) {
+          wdut->a = block_a[i];
+          wdut->b = block_b[i];
+          wdut->eval();
+          block_y[i] = wdut->y;
+          block_flags[i] = (wdut->exc_invalid << 4) | (wdut->exc_divzero << 3) | (wdut->exc_overflow << 2) |
+                           (wdut->exc_underflow << 1) | wdut->exc_inexact;
+          if (coverage_enabled) sample(wdut.get(), block + i, block_src[i]);
+        }
+#endif
+
+        reference_div_batch(reference_backend, block_a, block_b, block_ref, n);
+
+        // Verbose runs print every vector, so all of them take the full check
+        size_t bad = n;
+        if (verbose) {
+          for (size_t i = 0; i < n; ++i) block_bad[i] = static_cast<uint32_t>(i);
+        } else {
+          bad = tb::find_mismatches(block_y, block_flags, block_ref, n, block_bad);
+        }
+        size_t passed = n;
+        for (size_t k = 0; k < bad; ++k) {
+          size_t i = block_bad[k];
+          if (!check_random_vector(wdut.get(), block_a[i], block_b[i], block_ref[i], block_y[i], block_flags[i],
+                                   seed, block + i, verbose)) {
+            // Stop this worker (and signal the others) on failure
+            shard.failed = true;
+            passed = i;
+            break;
+          }
+        }
+        for (size_t i = 0; settings.metamorphic && i < passed && !shard.failed; ++i) {
+          if (!check_variants(wdut.get(), seed, block + i, block_a[i], block_b[i], block_ref[i],
+                              settings.metamorphic, verbose, worker_variants[worker])) {
+            shard.failed = true;
+            passed = i + 1;
+          }
+        }
+        shard.tested += passed;
+        if (shard.failed) break;
+      }
+#ifdef TB_LANES
+      xdut->final();
+#endif
+      wdut->final();
+      return shard;
+    });
+    random_result.tested += epoch_result.tested;
+    if (epoch_result.failed) {
+      random_result.failed = true;
+      break;
+    }
+    if (adaptive && epoch + epoch_len < settings.random_tests) {
+      tb::Coverage reached = coverage;
+      tb::AdaptiveWeights feedback(NUM_REGIONS, coverage.bins());
+      for (unsigned w = 0; w < jobs; ++w) {
+        reached.merge(worker_coverage[w]);
+        feedback.merge(worker_feedback[w]);
+      }
+      std::cout << "[ADAPT] " << (epoch + epoch_len) << " vectors: " << reached.unreached()
+                << " bins unreached" << std::endl;
+      adapt_region_weights(reached, feedback, base_weights);
+    }
+  }
+  double random_seconds = random_timer.seconds();
+  time_counter = random_result.tested;
+  uint64_t variants = 0;
+  for (uint64_t v : worker_variants) variants += v;
+  if (random_result.failed) {
+    dut->final();
+    delete dut;
+    return 1;  // Exit on first failure for random tests
+  }
+  std::cout << "Random throughput: " << std::fixed << std::setprecision(0)
+            << (random_result.tested / (random_seconds > 0 ? random_seconds : 1)) << " vectors/s ("
+            << std::setprecision(2) << random_seconds << " s)" << std::endl;
+  if (settings.metamorphic) {
+    std::cout << "Metamorphic variants: " << variants << " (" << std::setprecision(2)
+              << (time_counter ? static_cast<double>(variants) / time_counter : 0.0)
+              << " per random vector)" << std::endl;
   }
 
   // === Coverage analysis and reporting ===
   std::cout << "\n=== Test Coverage Summary ===" << std::endl;
+  std::cout << "Corpus vectors: " << num_corpus << std::endl;
   std::cout << "Corner cases: " << num_cc << std::endl;
   std::cout << "Systematic tests: " << systematic_tests << std::endl;
+  std::cout << "Hard-to-round tests: " << hard_tests << std::endl;
+  std::cout << "Exponent-band tests: " << band_tests << std::endl;
   std::cout << "Stratified random tests: " << time_counter << std::endl;
-  std::cout << "Total test vectors: " << (num_cc + systematic_tests + time_counter) << std::endl;
+  std::cout << "Metamorphic variants: " << variants << std::endl;
+  std::cout << "Total test vectors: "
+            << (num_corpus + num_cc + systematic_tests + hard_tests + band_tests + time_counter + variants) << std::endl;
   
   // Print region coverage statistics
-  std::cout << "\n=== Random Test Distribution ===" << std::endl;
+  std::cout << "\n=== Random Test Distribution" << (adaptive ? " (last epoch)" : "") << " ===" << std::endl;
   for (auto& region : regions) {
     double percentage = (double)region.weight / total_weight * 100.0;
     std::cout << region.name << ": " << std::fixed << std::setprecision(1) 
               << percentage << "%" << std::endl;
   }
 
+  // Coverage of all phases: unreached bins tell which cases the vector mix misses
+  if (coverage_enabled) {
+    for (const auto& wcov : worker_coverage) coverage.merge(wcov);
+    if (!coverage.report(40)) {
+      std::cout << "WARNING: bins assumed impossible were hit; check the coverage model" << std::endl;
+    }
+    if (!coverage_out.empty()) {
+      if (coverage.write(coverage_out)) {
+        std::cout << "Coverage bins written to " << coverage_out << std::endl;
+      } else {
+        std::cout << "ERROR: cannot write " << coverage_out << std::endl;
+      }
+    }
+  }
+
   dut->final();
   delete dut;
+  if (mismatches && mismatches->total()) {
+    mismatches->report();
+    return 1;
+  }
   return 0;
 }
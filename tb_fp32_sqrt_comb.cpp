@@ -1,215 +1,1178 @@
 #include "Vfp32_sqrt_comb.h"
+#include "Vfp32_sqrt_comb___024root.h"
+#include "Vfp32_sqrt_comb_fp32_sqrt_comb.h"
+#ifdef TB_LANES
+#include "Vfp32_sqrt_comb_xN.h"
+#endif
+#ifdef TB_LOCKSTEP
+#include "Vfp32_sqrt_comb_ref.h"
+#endif
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <ctime>
 #include <iomanip> // for std::hex and std::setw
 #include <iostream>
-#include <random>
+#include <memory>
+#include <string>
+#include <vector>
 #include <verilated.h>
+#include "fp32_host_ref.h"
+#include "fp32_ref_model.h"
+#include "fp32_sqrt_golden.h"
+#include "tb_bench.h"
+#include "tb_common.h"
+#include "tb_coverage.h"
+#include "tb_hard_cases.h"
+#include "tb_metamorphic.h"
+#include "tb_mismatch.h"
+#include "tb_shrink.h"
 extern "C" {
 #include "softfloat.h"
 }
 
-int time_counter = 0;
+uint64_t time_counter = 0;
+
+// Settings file read at startup (vector counts, region weights, corner-case file)
+static constexpr const char* DEFAULT_SETTINGS = "sqrt_tests.cfg";
+// Vectors per pipeline block in the random phase and exhaustive sweep
+static constexpr int REF_BATCH = 4096;
+// Vectors per region and stage, and best-of-N timing repeats, in --bench mode
+static constexpr int BENCH_VECTORS = 1 << 16;
+static constexpr int BENCH_REPEATS = 5;
+// Seed offset of the metamorphic variants of the random phase
+static constexpr uint64_t META_STREAM = 0x6d657461;
+// Stream of the backend validation vectors
+static constexpr uint64_t VALIDATION_SEED = 0x76616c69;
+
+/**
+ * @brief Run-time test settings (settings file, then command-line overrides)
+ */
+struct TestSettings {
+  uint64_t random_tests = 0;      // Stratified random test vectors
+  uint64_t validation_tests = 0;  // Backend-vs-SoftFloat vectors before a fast backend is used
+  uint64_t subnorm_step = 0;      // Step size for systematic subnormal inputs
+  uint64_t boundary_range = 0;    // Inputs in the boundary test centred on 1.0
+  uint64_t hard_tests = 0;        // Constructed hard-to-round inputs (exact squares are always added)
+  uint64_t metamorphic = 0;       // Metamorphic variants per random vector (0 = off)
+  std::string corner_file;        // Corner-case inputs
+};
+
+/**
+ * @brief Operand region for stratified random testing and per-region benchmarks
+ *
+ * Weights come from the settings file (regions it does not name get 0).
+ */
+struct TestRegion {
+  uint32_t start, end;
+  const char* name;
+  int weight;
+};
+
+// Stratified random testing - divide FP32 space into regions
+static TestRegion regions[] = {
+  {0x00000000, 0x00800000, "subnormals", 0},
+  {0x00800000, 0x34000000, "small_normals", 0},
+  {0x34000000, 0x3f000000, "medium_normals", 0},
+  {0x3f000000, 0x40800000, "near_one", 0},           // Critical for sqrt accuracy
+  {0x40800000, 0x7f000000, "large_normals", 0},
+  {0x7f000000, 0x7f800000, "near_overflow", 0},
+  {0x7f800000, 0x7fffffff, "special_values", 0},     // inf, NaN cases
+  // Negative values all produce NaN for sqrt, but still test
+  {0x80000000, 0x80000000, "neg_zero", 0},           // -0 -> -0
+  {0x80000001, 0xffffffff, "negative_vals", 0}       // All other negatives -> NaN
+};
+
+// Total weight and alias table for stratified sampling (rebuilt by
+// build_region_table() once the weights are set)
+static int total_weight = 0;
+static tb::AliasTable region_table;
+
+static void build_region_table() {
+  std::vector<uint64_t> weights;
+  total_weight = 0;
+  for (const auto& region : regions) {
+    weights.push_back(region.weight);
+    total_weight += region.weight;
+  }
+  if (total_weight) region_table.build(weights);
+}
+
+/**
+ * @brief Set the sampling weight of the region called `name`
+ */
+static bool set_region_weight(const std::string& name, const std::string& value) {
+  uint64_t weight;
+  if (!tb::parse_count(value, weight) || weight > 1000000) return false;
+  for (auto& region : regions) {
+    if (name == region.name) {
+      region.weight = static_cast<int>(weight);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Apply one "key value..." setting; relative file names resolve against `origin`
+ */
+static bool apply_setting(TestSettings& settings, const std::vector<std::string>& e, const std::string& origin) {
+  if (e[0] == "corner_file" && e.size() == 2) {
+    settings.corner_file = tb::resolve_relative(origin, e[1]);
+    return true;
+  }
+  if (e[0] == "random_tests" && e.size() == 2)     return tb::parse_count(e[1], settings.random_tests);
+  if (e[0] == "validation_tests" && e.size() == 2) return tb::parse_count(e[1], settings.validation_tests);
+  if (e[0] == "hard_tests" && e.size() == 2)       return tb::parse_count(e[1], settings.hard_tests);
+  if (e[0] == "metamorphic" && e.size() == 2)      return tb::parse_count(e[1], settings.metamorphic);
+  if (e[0] == "subnorm_step" && e.size() == 2)     return tb::parse_count(e[1], settings.subnorm_step) && settings.subnorm_step > 0;
+  if (e[0] == "boundary_range" && e.size() == 2) {
+    return tb::parse_count(e[1], settings.boundary_range) && settings.boundary_range <= 0x3f800000;
+  }
+  if (e[0] == "weight" && e.size() == 3)           return set_region_weight(e[1], e[2]);
+  return false;
+}
+
+/**
+ * @brief Load the settings file, then apply the command-line overrides
+ * @return false (after reporting the bad entry) on error
+ */
+static bool load_test_settings(const std::string& path, const std::vector<std::vector<std::string>>& overrides,
+                               TestSettings& settings) {
+  std::vector<std::vector<std::string>> entries;
+  if (!tb::load_settings(path, entries)) {
+    std::cout << "ERROR: cannot read test settings " << path
+              << " (run from the repository root or pass --config FILE)" << std::endl;
+    return false;
+  }
+  for (const auto& e : entries) {
+    if (!apply_setting(settings, e, path)) {
+      std::cout << "ERROR: bad entry '" << e[0] << (e.size() > 1 ? " " + e[1] : "") << "' in " << path << std::endl;
+      return false;
+    }
+  }
+  for (const auto& e : overrides) {
+    if (!apply_setting(settings, e, "")) {
+      std::cout << "ERROR: bad command-line value for " << e[0] << std::endl;
+      return false;
+    }
+  }
+
+  build_region_table();
+  if (total_weight == 0 || settings.subnorm_step == 0 || settings.corner_file.empty()) {
+    std::cout << "ERROR: " << path << " must set corner_file, subnorm_step and at least one weight" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Input drawn uniformly from `region` (inclusive bounds)
+ */
+static uint32_t region_input(tb::VectorRng& rng, const TestRegion& region) {
+  uint64_t span = static_cast<uint64_t>(region.end) - region.start + 1;
+  return region.start + (span >> 32 ? rng.next() : rng.below(static_cast<uint32_t>(span)));
+}
+
+/**
+ * @brief Input of stratified random vector `index` under `seed`
+ *
+ * The region comes from the alias table (exact weights, no search), and
+ * bounded draws are unbiased. Every draw comes from the vector's own
+ * counter-based stream, so the input depends only on (seed, index) and the
+ * region weights.
+ */
+static uint32_t random_vector(uint64_t seed, uint64_t index) {
+  tb::VectorRng rng(seed, index);
+  return region_input(rng, regions[region_table.pick(rng)]);
+}
+
+/**
+ * @brief Random vectors first .. first + n - 1 (n <= REF_BATCH) of `seed`
+ *
+ * The stream keys of the whole block are derived in one vectorizable loop;
+ * any worker can generate any block from its first index alone.
+ */
+static void random_block(uint64_t seed, uint64_t first, size_t n, uint32_t* a_bits) {
+  uint64_t keys[REF_BATCH];
+  tb::VectorRng::keys(seed, first, n, keys);
+  for (size_t i = 0; i < n; ++i) {
+    tb::VectorRng rng(keys[i]);
+    a_bits[i] = region_input(rng, regions[region_table.pick(rng)]);
+  }
+}
+
+/**
+ * @brief Options that regenerate one random vector (`extra`: further options)
+ */
+static std::string replay_args(uint64_t seed, uint64_t index, const std::string& extra = "") {
+  std::ostringstream args;
+  args << "--replay 0x" << std::hex << seed << std::dec << ":" << index << extra;
+  return args.str();
+}
+
+// --keep-going: mismatch classes of the whole run (nullptr: stop at the first mismatch)
+static tb::MismatchClusters* mismatches = nullptr;
+
+/**
+ * @brief Reference implementation used by compare_with_softfloat
+ */
+enum class RefBackend { SoftFloat, Model, Host, Golden };
+static RefBackend reference_backend = RefBackend::SoftFloat;
+
+// Precomputed f32_sqrt results (gen_sqrt_golden), mapped when --ref golden is used
+static fp32_golden::SqrtTable golden_table;
+static constexpr const char* DEFAULT_GOLDEN_TABLE = "sqrt_golden.bin";
+
+static const char* backend_name(RefBackend backend) {
+  switch (backend) {
+    case RefBackend::Model: return "native model";
+    case RefBackend::Host:  return "host FPU + SoftFloat fallback";
+    case RefBackend::Golden: return "golden table";
+    default:                return "SoftFloat";
+  }
+}
+
+/**
+ * @brief SoftFloat f32_sqrt with its exception flags
+ */
+static fp32_ref::Result softfloat_sqrt(uint32_t a_bits) {
+  softfloat_exceptionFlags = 0;
+  float32_t a_sf;
+  a_sf.v = a_bits;
+  float32_t r_sf = f32_sqrt(a_sf);
+  return {r_sf.v, static_cast<uint8_t>(softfloat_exceptionFlags)};
+}
+
+/**
+ * @brief Reference results for n inputs with the selected backend
+ */
+static void reference_sqrt_batch(RefBackend backend, const uint32_t* a, fp32_ref::Result* out, size_t n) {
+  switch (backend) {
+    case RefBackend::Host:
+      fp32_host::sqrt_batch(a, out, n, softfloat_sqrt);
+      break;
+    case RefBackend::Model:
+      for (size_t i = 0; i < n; ++i) out[i] = fp32_ref::sqrt(a[i]);
+      break;
+    case RefBackend::Golden:
+      for (size_t i = 0; i < n; ++i) out[i] = golden_table.lookup(a[i]);
+      break;
+    default:
+      for (size_t i = 0; i < n; ++i) out[i] = softfloat_sqrt(a[i]);
+      break;
+  }
+}
+
+/**
+ * @brief Check a fast reference backend against SoftFloat before trusting it as oracle
+ */
+static bool validate_reference_backend(RefBackend backend, unsigned jobs, uint64_t total) {
+  tb::ShardResult result = tb::run_sharded(jobs, total,
+      [&](unsigned, uint64_t begin, uint64_t end, std::atomic<bool>& stop) {
+    tb::ShardResult shard;
+    uint32_t block_a[REF_BATCH];
+    uint64_t keys[REF_BATCH];
+    fp32_ref::Result block_ref[REF_BATCH];
+    for (uint64_t block = begin; block < end && !stop.load(std::memory_order_relaxed); block += REF_BATCH) {
+      size_t n = static_cast<size_t>(std::min<uint64_t>(REF_BATCH, end - block));
+      tb::VectorRng::keys(VALIDATION_SEED, block, n, keys);
+      for (size_t i = 0; i < n; ++i) block_a[i] = tb::VectorRng(keys[i]).next();
+      reference_sqrt_batch(backend, block_a, block_ref, n);
+      for (size_t i = 0; i < n; ++i) {
+        fp32_ref::Result ref = softfloat_sqrt(block_a[i]);
+        if (block_ref[i].y != ref.y || block_ref[i].flags != ref.flags) {
+          std::lock_guard<std::mutex> lock(tb::output_mutex());
+          std::cout << "[" << backend_name(backend) << "] mismatch: a=0x" << std::hex << std::setw(8)
+                    << std::setfill('0') << block_a[i]
+                    << " backend=0x" << std::setw(8) << block_ref[i].y << " flags=0x" << (int)block_ref[i].flags
+                    << " softfloat=0x" << std::setw(8) << ref.y << " flags=0x" << (int)ref.flags
+                    << std::dec << std::endl;
+          shard.failed = true;
+          return shard;
+        }
+        shard.tested++;
+      }
+    }
+    return shard;
+  });
+  return !result.failed;
+}
+
+/**
+ * @brief Evaluate one random vector on a DUT instance and compare against the reference
+ *
+ * Each worker passes its own DUT; SoftFloat flags are thread-local, so this
+ * is safe to call concurrently. Reports are serialized on tb::output_mutex().
+ */
+static bool compare_with_softfloat(Vfp32_sqrt_comb* dut, uint32_t a_bits, uint64_t index, bool verbose,
+                                   const fp32_ref::Result* precomputed = nullptr) {
+  union {
+    float f;
+    uint32_t u;
+  } conv;
+  conv.u = a_bits;
+  dut->a = conv.u;
+  dut->eval(); // Evaluate the design
+
+  // Convert the output back to float
+  union {
+    uint32_t u;
+    float f;
+  } out_conv;
+  out_conv.u = dut->y;
+
+  // reference sqrt: precomputed by a batch backend, or computed here
+  fp32_ref::Result ref;
+  if (precomputed) {
+    ref = *precomputed;
+  } else {
+    reference_sqrt_batch(reference_backend, &conv.u, &ref, 1);
+  }
+  int math_flags = ref.flags;
+  union {
+    uint32_t u;
+    float f;
+  } math_conv;
+  math_conv.u = ref.y;
+
+  // ULP diff - use unsigned comparison for correct handling of negative numbers
+  uint32_t ulp_diff;
+  if (out_conv.u == math_conv.u) {
+    ulp_diff = 0;
+  } else if ((out_conv.u ^ math_conv.u) & 0x80000000) {
+    // Different signs - handle zero crossing case
+    ulp_diff = (out_conv.u & 0x7FFFFFFF) + (math_conv.u & 0x7FFFFFFF);
+  } else {
+    // Same sign - simple unsigned difference
+    ulp_diff = (out_conv.u > math_conv.u) ? (out_conv.u - math_conv.u) : (math_conv.u - out_conv.u);
+  }
+  // collect RTL exception flags and compare
+  int dut_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) |
+                  (dut->exc_overflow << 2) | (dut->exc_underflow << 1) |
+                  (dut->exc_inexact);
+  bool flag_pass = (dut_flags == math_flags);
+
+  // If both outputs are NaN, consider as PASS
+  bool is_nan_case = std::isnan(math_conv.f) && std::isnan(out_conv.f);
+  // strict match: NaN bit patterns must match exactly (including payload)
+  bool pass = is_nan_case ? (out_conv.u == math_conv.u) : (ulp_diff == 0);
+  bool overall_pass = pass && flag_pass;
+
+  // Print only failures (--keep-going: the first ones) or verbose mode
+  if ((!overall_pass && (!mismatches || mismatches->claim_report())) || verbose) {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    std::cout << "Time: " << index << " | sqrt_in: " << conv.f
+              << " (bits=0x" << std::hex << std::setw(8) << std::setfill('0')
+              << conv.u << std::dec << ")" << " | sqrt_out(rtl): " << out_conv.f
+              << " (bits=0x" << std::hex << std::setw(8) << std::setfill('0')
+              << out_conv.u << std::dec << ")"
+              << " | sqrt_out(math): " << math_conv.f << " (bits=0x" << std::hex
+              << std::setw(8) << std::setfill('0') << math_conv.u << std::dec
+              << ")" << " | ulp_diff: " << ulp_diff
+              << (pass ? " PASS" : " FAIL")
+              << " | FLAG=" << (flag_pass ? " PASS" : " FAIL")
+              << " | math_flags=0x" << std::hex << math_flags << std::dec
+              << " | dut_flags=0x" << std::hex << dut_flags << std::dec
+              << std::endl;
+  }
+
+  return overall_pass;
+}
+
+/**
+ * @brief Failure corpus: "a [expected flags actual flags source]" per line
+ */
+static constexpr const char* DEFAULT_CORPUS = "sqrt_corpus.txt";
+static tb::FailureCorpus failure_corpus("sqrt", 1);
+
+/**
+ * @brief Append a failing input to the corpus, with the result `dut` holds for it
+ *
+ * Call right after the failing evaluation; the expected result is SoftFloat's.
+ */
+static void record_failure(Vfp32_sqrt_comb* dut, uint32_t a_bits, const char* source) {
+  fp32_ref::Result expected = softfloat_sqrt(a_bits);
+  unsigned rtl_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) | (dut->exc_overflow << 2) |
+                       (dut->exc_underflow << 1) | dut->exc_inexact;
+  failure_corpus.append({a_bits}, expected.y, expected.flags, dut->y, rtl_flags, source);
+}
+
+/**
+ * @brief Datapath the input last evaluated on `dut` took
+ */
+static const char* sqrt_datapath(Vfp32_sqrt_comb* dut) {
+  const auto* m = dut->fp32_sqrt_comb;
+  return m->dbg_special_path ? "special" : m->dbg_subnormal_in ? "subnormal" : "normal";
+}
+
+/**
+ * @brief The input `a_bits` as `dut` evaluated it, against SoftFloat
+ */
+static tb::MismatchClusters::Vector sqrt_mismatch(Vfp32_sqrt_comb* dut, uint32_t a_bits,
+                                                  const std::string& origin = "") {
+  fp32_ref::Result expected = softfloat_sqrt(a_bits);
+  unsigned rtl_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) | (dut->exc_overflow << 2) |
+                       (dut->exc_underflow << 1) | dut->exc_inexact;
+  return {{a_bits}, expected.y, dut->y, expected.flags, rtl_flags, origin};
+}
+
+/**
+ * @brief Shrink the failing input `a_bits` and add the result to the corpus
+ *
+ * Candidates are kept while they still mismatch and fall into the same
+ * mismatch class (see tb_shrink.h). `dut` holds `a_bits` again afterwards.
+ * Nothing is shrunk or recorded if the DUT matches SoftFloat on the vector.
+ */
+static void minimize_failure(Vfp32_sqrt_comb* dut, uint32_t a_bits, const char* source) {
+  // Class key of a, or "" if the DUT gets it right
+  auto mismatch_class = [dut](uint32_t a) {
+    dut->a = a;
+    dut->eval();
+    tb::MismatchClusters::Vector v = sqrt_mismatch(dut, a);
+    if (v.actual == v.expected && v.actual_flags == v.expected_flags) return std::string();
+    return tb::MismatchClusters::classify(sqrt_datapath(dut), v);
+  };
+  std::string target = mismatch_class(a_bits);
+  // Flagged by an oracle other than SoftFloat (--ref, metamorphic variant)
+  // while the DUT matches SoftFloat: there is no class to shrink within
+  if (target.empty()) return;
+  std::vector<uint32_t> ops = {a_bits};
+  unsigned evals = tb::shrink_operands(ops, [&](const std::vector<uint32_t>& c) {
+    return mismatch_class(c[0]) == target;
+  });
+  if (ops[0] != a_bits) {
+    mismatch_class(ops[0]);
+    record_failure(dut, ops[0], (std::string(source) + "/min").c_str());
+  }
+  {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    std::cout << "Minimized: " << std::hex << std::setfill('0') << "0x" << std::setw(8) << a_bits << " -> 0x"
+              << std::setw(8) << ops[0] << std::dec << " (" << evals << " evaluations)" << std::endl;
+  }
+  mismatch_class(a_bits);
+}
+
+/**
+ * @brief Handle the mismatch `dut` just produced for `a_bits`
+ *
+ * Without --keep-going the input goes to the corpus (if `to_corpus`), the
+ * replay options of a random vector are printed and the run stops. With
+ * --keep-going it joins its mismatch class; only class representatives go
+ * to the corpus. Either way the input is then minimized, and the minimized
+ * input goes to the corpus too.
+ * @return true to continue with the next input
+ */
+static bool on_mismatch(Vfp32_sqrt_comb* dut, uint32_t a_bits, const char* source, bool to_corpus = true,
+                        const std::string& replay = "") {
+  bool representative = true;
+  if (mismatches) {
+    std::string origin = replay.empty() ? source : std::string(source) + " " + replay;
+    representative = mismatches->add(sqrt_datapath(dut), sqrt_mismatch(dut, a_bits, origin));
+  } else if (!replay.empty()) {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    std::cout << "Replay: " << replay << std::endl;
+  }
+  if (representative) {
+    if (to_corpus) record_failure(dut, a_bits, source);
+    minimize_failure(dut, a_bits, source);
+  }
+  return mismatches != nullptr;
+}
+
+/**
+ * @brief Check `count` metamorphic variants of random vector `index` against its reference result
+ *
+ * Variants depend only on (seed, index), so --replay checks the same ones.
+ * @return false if a variant mismatched and the run should stop
+ */
+static bool check_variants(Vfp32_sqrt_comb* dut, uint64_t seed, uint64_t index, uint32_t a_bits,
+                           const fp32_ref::Result& ref, uint64_t count, bool verbose, uint64_t& checked) {
+  tb::VectorRng rng(seed ^ META_STREAM, index);
+  tb::Variant v;
+  for (uint64_t i = 0; i < count; ++i) {
+    if (!tb::sqrt_variant(rng, a_bits, ref, v)) break;
+    if (!compare_with_softfloat(dut, v.a, index, verbose, &v.expected)) {
+      if (!mismatches) {
+        std::lock_guard<std::mutex> lock(tb::output_mutex());
+        std::cout << "[SQRT META] variant " << v.transform << " of input 0x" << std::hex << std::setw(8)
+                  << std::setfill('0') << a_bits << std::dec << std::endl;
+      }
+      if (!on_mismatch(dut, v.a, "metamorphic", true,
+                       replay_args(seed, index, " --metamorphic " + std::to_string(count)))) {
+        return false;
+      }
+    }
+    checked++;
+  }
+  return true;
+}
+
+/**
+ * @brief Coverage group over the square root debug signals
+ *
+ * path: special (NaN, negative, inf, zero), even or odd unbiased exponent;
+ * input: normal or subnormal (normalized first); gs: guard/sticky;
+ * round_up / carry: rounding increment and its carry into the exponent.
+ */
+static tb::Coverage make_sqrt_coverage() {
+  tb::Coverage coverage("fp32_sqrt_comb path x input x gs x round_up x carry x flags", {
+      {"path", {"special", "even", "odd"}},
+      {"input", {"normal", "subnormal"}},
+      {"gs", {"g0s0", "g0s1", "g1s0", "g1s1"}},
+      {"round_up", {"0", "1"}},
+      {"carry", {"0", "1"}},
+      {"flags", {"none", "inexact", "invalid"}}});
+  coverage.mark_impossible([](const unsigned* v) {
+    // Special path: datapath debug signals stay 0, no rounding flags
+    if (v[0] == 0) return v[1] != 0 || v[2] != 0 || v[3] != 0 || v[4] != 0 || v[5] == 1;
+    // invalid comes from the special path only; inexact exactly when g or s
+    if (v[5] != (v[2] == 0 ? 0u : 1u)) return true;
+    // The root of a 24-bit mantissa is never a 25-bit tie
+    if (v[2] == 2) return true;
+    // Round to nearest even: up when guard and sticky, never without guard
+    if (v[2] == 3 ? v[3] == 0 : v[2] < 2 && v[3] == 1) return true;
+    // The largest root, sqrt(4 - 2^-22), stays below 2 - 2^-24: no carry
+    return v[4] == 1;
+  });
+  return coverage;
+}
+
+/**
+ * @brief Coverage bin of the input last evaluated on `dut`
+ */
+static size_t sqrt_coverage_bin(const tb::Coverage& coverage, Vfp32_sqrt_comb* dut) {
+  const auto* m = dut->fp32_sqrt_comb;
+  unsigned path = m->dbg_special_path ? 0 : m->dbg_exp_odd ? 2 : 1;
+  unsigned flags = dut->exc_invalid ? 2 : dut->exc_inexact ? 1 : 0;
+  return coverage.bin({path, m->dbg_subnormal_in, m->dbg_guard_bit * 2u + m->dbg_sticky_bit,
+                       m->dbg_round_up, m->dbg_round_carry, flags});
+}
+
+/**
+ * @brief Merge per-worker coverage into `coverage`, report it and optionally write the bins
+ */
+static void report_coverage(tb::Coverage& coverage, const std::vector<tb::Coverage>& worker_coverage,
+                            const std::string& out_path) {
+  for (const auto& wcov : worker_coverage) coverage.merge(wcov);
+  if (!coverage.report(40)) {
+    std::cout << "WARNING: bins assumed impossible were hit; check the coverage model" << std::endl;
+  }
+  if (!out_path.empty()) {
+    if (coverage.write(out_path)) {
+      std::cout << "Coverage bins written to " << out_path << std::endl;
+    } else {
+      std::cout << "ERROR: cannot write " << out_path << std::endl;
+    }
+  }
+}
+
+#ifdef TB_LANES
+static_assert(TB_LANES > 2 && TB_LANES <= 32, "TB_LANES must be 3..32 (wide data ports, scalar flag ports)");
+
+/**
+ * @brief Evaluate n <= TB_LANES inputs with a single eval() of the multi-lane model
+ */
+static void eval_lanes(Vfp32_sqrt_comb_xN* xdut, const uint32_t* a, size_t n, uint32_t* y, uint8_t* flags) {
+  for (size_t l = 0; l < TB_LANES; ++l) {
+    xdut->a[l] = l < n ? a[l] : 0x3f800000;  // idle lanes compute sqrt(1)
+  }
+  xdut->eval();
+  for (size_t l = 0; l < n; ++l) {
+    y[l] = xdut->y[l];
+    flags[l] = (((xdut->exc_invalid >> l) & 1) << 4) | (((xdut->exc_divzero >> l) & 1) << 3) |
+               (((xdut->exc_overflow >> l) & 1) << 2) | (((xdut->exc_underflow >> l) & 1) << 1) |
+               ((xdut->exc_inexact >> l) & 1);
+  }
+}
+#endif
+
+/**
+ * @brief Full check of input `index`, whose block result (y, flags) was not bit-identical to ref
+ *
+ * The input is replayed on the scalar DUT through compare_with_softfloat,
+ * which applies the full pass criteria and prints the report. In lane
+ * builds the replay must also reproduce the lane's output; a lane that
+ * disagrees with the scalar DUT always stops the run.
+ * Mismatches go through on_mismatch() as `source`, with replay options when
+ * `replay_seed` is given, and are counted in `mismatched`.
+ * @return false if the run should stop
+ */
+static bool check_input(Vfp32_sqrt_comb* dut, uint32_t a, const fp32_ref::Result& ref, uint32_t y, uint8_t flags,
+                        uint64_t index, bool verbose, const char* source, const uint64_t* replay_seed,
+                        unsigned& mismatched) {
+  if (!compare_with_softfloat(dut, a, index, verbose, &ref)) {
+    ++mismatched;
+    return on_mismatch(dut, a, source, true, replay_seed ? replay_args(*replay_seed, index) : "");
+  }
+#ifdef TB_LANES
+  int dut_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) | (dut->exc_overflow << 2) |
+                  (dut->exc_underflow << 1) | dut->exc_inexact;
+  if (y != dut->y || flags != dut_flags) {
+    std::lock_guard<std::mutex> lock(tb::output_mutex());
+    std::cout << "Time: " << index << " | lane disagrees with scalar DUT: lane=0x" << std::hex << std::setw(8)
+              << std::setfill('0') << y << " flags=0x" << (int)flags << " scalar=0x" << std::setw(8) << dut->y
+              << " flags=0x" << dut_flags << std::dec << std::endl;
+    if (replay_seed) std::cout << "Replay: " << replay_args(*replay_seed, index) << std::endl;
+    record_failure(dut, a, source);
+    return false;
+  }
+#else
+  (void)y;
+  (void)flags;
+#endif
+  return true;
+}
+
+/**
+ * @brief Indices of block entries that need check_input(): bitwise mismatches, or all n in verbose runs
+ * @return Number of indices written to `bad`
+ */
+static size_t block_candidates(const uint32_t* y, const uint8_t* flags, const fp32_ref::Result* ref, size_t n,
+                               bool verbose, uint32_t* bad) {
+  if (!verbose) return tb::find_mismatches(y, flags, ref, n, bad);
+  for (size_t i = 0; i < n; ++i) bad[i] = static_cast<uint32_t>(i);
+  return n;
+}
+
+/**
+ * @brief Exhaustive sweep configuration: 2^32 inputs in 2^24-input chunks
+ */
+namespace Exhaustive {
+  static constexpr int      CHUNK_BITS = 24;
+  static constexpr uint32_t NUM_CHUNKS = 1u << (32 - CHUNK_BITS);
+  static constexpr const char* DEFAULT_CHECKPOINT = "sqrt_exhaustive.ckpt";
+}
+
+/**
+ * @brief Check every 32-bit input against f32_sqrt, resuming from a checkpoint
+ *
+ * Chunks are handed out dynamically to `jobs` workers; each completed chunk
+ * is appended to the checkpoint file so a killed run resumes where it stopped.
+ * Coverage covers the chunks swept by this run only.
+ * @return process exit code (0 = all chunks verified)
+ */
+static int run_exhaustive(unsigned jobs, const std::string& checkpoint_path, bool verbose,
+                          bool coverage_enabled, const std::string& coverage_out) {
+  std::cout << "=== Exhaustive 2^32 sweep ===" << std::endl;
+  tb::ChunkCheckpoint checkpoint(checkpoint_path,
+                                 "fp32_sqrt_comb exhaustive chunk_bits=" + std::to_string(Exhaustive::CHUNK_BITS),
+                                 Exhaustive::NUM_CHUNKS);
+  if (!checkpoint.open()) {
+    std::cout << "ERROR: cannot use checkpoint file " << checkpoint_path
+              << " (unwritable or from a different sweep)" << std::endl;
+    return 1;
+  }
+  std::vector<uint32_t> pending = checkpoint.pending();
+  std::cout << "Checkpoint: " << checkpoint_path << " ("
+            << (Exhaustive::NUM_CHUNKS - pending.size()) << "/" << Exhaustive::NUM_CHUNKS
+            << " chunks already verified)" << std::endl;
+  std::cout << "Worker threads: " << jobs << std::endl;
+  std::cout << "Reference: " << backend_name(reference_backend) << std::endl;
+#ifdef TB_LANES
+  std::cout << "Lanes per eval(): " << TB_LANES << std::endl;
+#endif
+
+  tb::WorkQueue queue(pending);
+  std::atomic<uint32_t> chunks_done(Exhaustive::NUM_CHUNKS - pending.size());
+  std::atomic<uint64_t> vectors_done(0);
+  tb::Stopwatch timer;
+  std::vector<tb::Coverage> worker_coverage(jobs, make_sqrt_coverage());
+  tb::ShardResult result = tb::run_workers(jobs, [&](unsigned worker, std::atomic<bool>& stop) {
+    tb::ShardResult shard;
+    tb::Coverage& wcov = worker_coverage[worker];
+    std::unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+    std::unique_ptr<Vfp32_sqrt_comb> wdut(new Vfp32_sqrt_comb(contextp.get()));
+#ifdef TB_LANES
+    std::unique_ptr<Vfp32_sqrt_comb_xN> xdut(new Vfp32_sqrt_comb_xN(contextp.get()));
+#endif
+    // Block pipeline: all DUT evals, all reference computations, then one
+    // compare pass; only mismatching inputs are formatted
+    uint32_t block_a[REF_BATCH];
+    uint32_t block_y[REF_BATCH];
+    uint8_t block_flags[REF_BATCH];
+    fp32_ref::Result block_ref[REF_BATCH];
+    uint32_t block_bad[REF_BATCH];
+    uint32_t chunk;
+    while (!stop.load(std::memory_order_relaxed) && queue.claim(chunk)) {
+      uint64_t first = static_cast<uint64_t>(chunk) << Exhaustive::CHUNK_BITS;
+      uint64_t last  = first + (1ull << Exhaustive::CHUNK_BITS);
+      unsigned mismatched = 0;  // --keep-going: a chunk with mismatches is not marked verified
+      for (uint64_t block = first; block < last && !shard.failed; block += REF_BATCH) {
+        if (stop.load(std::memory_order_relaxed)) break;
+        for (size_t i = 0; i < REF_BATCH; ++i) block_a[i] = static_cast<uint32_t>(block + i);
+#ifdef TB_LANES
+        for (size_t i = 0; i < REF_BATCH; i += TB_LANES) {
+          eval_lanes(xdut.get(), block_a + i, std::min<size_t>(TB_LANES, REF_BATCH - i), block_y + i,
+                     block_flags + i);
+        }
+        // The wrapper has no debug ports: sample coverage on the scalar model
+        for (size_t i = 0; coverage_enabled && i < REF_BATCH; ++i) {
+          wdut->a = block_a[i];
+          wdut->eval();
+          wcov.hit(sqrt_coverage_bin(wcov, wdut.get()), block + i);
+        }
+#else
+        for (size_t i = 0; i < REF_BATCH; ++i) {
+          wdut->a = block_a[i];
+          wdut->eval();
+          block_y[i] = wdut->y;
+          block_flags[i] = (wdut->exc_invalid << 4) | (wdut->exc_divzero << 3) | (wdut->exc_overflow << 2) |
+                           (wdut->exc_underflow << 1) | wdut->exc_inexact;
+          if (coverage_enabled) wcov.hit(sqrt_coverage_bin(wcov, wdut.get()), block + i);
+        }
+#endif
+        reference_sqrt_batch(reference_backend, block_a, block_ref, REF_BATCH);
+        size_t bad = block_candidates(block_y, block_flags, block_ref, REF_BATCH, verbose, block_bad);
+        for (size_t k = 0; k < bad; ++k) {
+          size_t i = block_bad[k];
+          if (!check_input(wdut.get(), block_a[i], block_ref[i], block_y[i], block_flags[i], block + i, verbose,
+                           "exhaustive", nullptr, mismatched)) {
+            shard.failed = true;
+            break;
+          }
+        }
+      }
+      if (shard.failed || stop.load(std::memory_order_relaxed)) break;
+      shard.tested += last - first;
+      if (!mismatched) checkpoint.mark_done(chunk);
+
+      // Progress report: chunks verified overall, rate for this run
+      uint32_t done = ++chunks_done;
+      uint64_t checked = (vectors_done += last - first);
+      double elapsed = timer.seconds();
+      std::lock_guard<std::mutex> lock(tb::output_mutex());
+      std::cout << "[EXHAUSTIVE] chunk 0x" << std::hex << std::setw(2) << std::setfill('0') << chunk
+                << std::dec << " done (" << done << "/" << Exhaustive::NUM_CHUNKS << ") ";
+      if (mismatched) std::cout << mismatched << " mismatches, not checkpointed, ";
+      std::cout << std::fixed << std::setprecision(0)
+                << (checked / (elapsed > 0 ? elapsed : 1)) << " vectors/s" << std::endl;
+    }
+#ifdef TB_LANES
+    xdut->final();
+#endif
+    wdut->final();
+    return shard;
+  });
+  double seconds = timer.seconds();
+
+  std::cout << "\n=== Exhaustive Sweep Summary ===" << std::endl;
+  std::cout << "Vectors checked this run: " << result.tested << std::endl;
+  std::cout << "Elapsed: " << std::fixed << std::setprecision(2) << seconds << " s" << std::endl;
+  std::cout << "Throughput: " << std::setprecision(0)
+            << (result.tested / (seconds > 0 ? seconds : 1)) << " vectors/s" << std::endl;
+  if (result.failed || (mismatches && mismatches->total())) {
+    if (mismatches) mismatches->report();
+    std::cout << "Exhaustive sweep FAILED" << std::endl;
+    return 1;
+  }
+  if (coverage_enabled) {
+    tb::Coverage coverage = make_sqrt_coverage();
+    report_coverage(coverage, worker_coverage, coverage_out);
+  }
+  std::cout << "All " << Exhaustive::NUM_CHUNKS << " chunks verified: fp32_sqrt_comb matches f32_sqrt "
+            << "for every input" << std::endl;
+  return 0;
+}
+
+#ifdef TB_LOCKSTEP
+/**
+ * @brief Sweep every 32-bit input through the DUT and the reference RTL, bit for bit
+ *
+ * The reference RTL (Vfp32_sqrt_comb_ref) is a trusted revision verilated
+ * next to the DUT (see `make sqrt_lockstep`). Without SoftFloat in the loop
+ * the sweep runs at two evals per input; chunks of the exhaustive sweep are
+ * handed out to `jobs` workers. The first disagreement stops the sweep and
+ * goes to the failure corpus, so a normal run then tells which side is wrong.
+ * @return process exit code (0 = bit-identical on all inputs)
+ */
+static int run_lockstep(unsigned jobs) {
+  std::cout << "=== Lockstep 2^32 sweep: fp32_sqrt_comb vs reference RTL ===" << std::endl;
+  std::cout << "Worker threads: " << jobs << std::endl;
+  std::vector<uint32_t> chunks(Exhaustive::NUM_CHUNKS);
+  for (uint32_t c = 0; c < Exhaustive::NUM_CHUNKS; ++c) chunks[c] = c;
+  tb::WorkQueue queue(chunks);
+  std::atomic<uint32_t> chunks_done(0);
+  tb::Stopwatch timer;
+  tb::ShardResult result = tb::run_workers(jobs, [&](unsigned, std::atomic<bool>& stop) {
+    tb::ShardResult shard;
+    std::unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+    std::unique_ptr<Vfp32_sqrt_comb> wdut(new Vfp32_sqrt_comb(contextp.get()));
+    std::unique_ptr<Vfp32_sqrt_comb_ref> wref(new Vfp32_sqrt_comb_ref(contextp.get()));
+    uint32_t chunk;
+    while (!shard.failed && !stop.load(std::memory_order_relaxed) && queue.claim(chunk)) {
+      uint64_t first = static_cast<uint64_t>(chunk) << Exhaustive::CHUNK_BITS;
+      uint64_t last  = first + (1ull << Exhaustive::CHUNK_BITS);
+      for (uint64_t x = first; x < last; ++x) {
+        wdut->a = wref->a = static_cast<uint32_t>(x);
+        wdut->eval();
+        wref->eval();
+        int dut_flags = (wdut->exc_invalid << 4) | (wdut->exc_divzero << 3) | (wdut->exc_overflow << 2) |
+                        (wdut->exc_underflow << 1) | wdut->exc_inexact;
+        int ref_flags = (wref->exc_invalid << 4) | (wref->exc_divzero << 3) | (wref->exc_overflow << 2) |
+                        (wref->exc_underflow << 1) | wref->exc_inexact;
+        if (wdut->y == wref->y && dut_flags == ref_flags) continue;
+        {
+          std::lock_guard<std::mutex> lock(tb::output_mutex());
+          std::cout << "[LOCKSTEP] sqrt_in=0x" << std::hex << std::setfill('0') << std::setw(8) << x
+                    << " rtl=0x" << std::setw(8) << wdut->y << " flags=0x" << dut_flags << " ref_rtl=0x"
+                    << std::setw(8) << wref->y << " flags=0x" << ref_flags << std::dec << std::endl;
+        }
+        record_failure(wdut.get(), static_cast<uint32_t>(x), "lockstep");
+        shard.failed = true;
+        break;
+      }
+      if (shard.failed || stop.load(std::memory_order_relaxed)) break;
+      shard.tested += last - first;
+
+      uint32_t done = ++chunks_done;
+      double elapsed = timer.seconds();
+      std::lock_guard<std::mutex> lock(tb::output_mutex());
+      std::cout << "[LOCKSTEP] chunk 0x" << std::hex << std::setw(2) << std::setfill('0') << chunk << std::dec
+                << " done (" << done << "/" << Exhaustive::NUM_CHUNKS << ") " << std::fixed
+                << std::setprecision(0) << (static_cast<double>(done) * (1ull << Exhaustive::CHUNK_BITS) /
+                                            (elapsed > 0 ? elapsed : 1)) << " inputs/s" << std::endl;
+    }
+    wref->final();
+    wdut->final();
+    return shard;
+  });
+  std::cout << "Inputs checked: " << result.tested << " (" << std::fixed << std::setprecision(2) << timer.seconds()
+            << " s)" << std::endl;
+  if (result.failed) {
+    std::cout << "Lockstep FAILED: the DUT and the reference RTL disagree" << std::endl;
+    return 1;
+  }
+  std::cout << "Lockstep passed: fp32_sqrt_comb is bit-identical to the reference RTL on all 2^32 inputs"
+            << std::endl;
+  return 0;
+}
+#endif
+
+/**
+ * @brief Per-region, per-stage throughput benchmark (--bench)
+ *
+ * Stages, in ns/vector over BENCH_VECTORS inputs drawn from each region:
+ * gen (input generation), eval (dut->eval() with output reads), eval_xN in
+ * lane builds (one wrapper eval() per TB_LANES inputs), ref_softfloat,
+ * ref_model, ref_host and ref_golden (reference backends; ref_golden only when the
+ * golden table is available), and check (compare_with_softfloat
+ * with a precomputed reference: eval plus comparison).
+ * @return process exit code (1 = output not written or baseline regression)
+ */
+static int run_bench(const std::string& out_path, const std::string& baseline_path, double tolerance_pct) {
+  std::cout << "=== Throughput benchmark ===" << std::endl;
+  std::unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+  std::unique_ptr<Vfp32_sqrt_comb> bdut(new Vfp32_sqrt_comb(contextp.get()));
+#ifdef TB_LANES
+  std::unique_ptr<Vfp32_sqrt_comb_xN> xdut(new Vfp32_sqrt_comb_xN(contextp.get()));
+#endif
+  const size_t n = BENCH_VECTORS;
+  std::vector<uint32_t> a(n);
+  std::vector<fp32_ref::Result> ref(n);
+  volatile uint32_t sink = 0;  // keeps timed loops from being optimized away
+  tb::BenchReport report("sqrt");
+
+  for (const auto& region : regions) {
+    double gen_ns = tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      for (size_t i = 0; i < n; ++i) {
+        tb::VectorRng rng(0xbe7c0000u, i);
+        a[i] = region_input(rng, region);
+      }
+    });
+    double eval_ns = tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      uint32_t acc = 0;
+      for (size_t i = 0; i < n; ++i) {
+        bdut->a = a[i];
+        bdut->eval();
+        acc += bdut->y + bdut->exc_inexact;
+      }
+      sink = sink + acc;
+    });
+#ifdef TB_LANES
+    double eval_xn_ns = tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      uint32_t acc = 0;
+      for (size_t i = 0; i < n; i += TB_LANES) {
+        for (size_t l = 0; l < TB_LANES; ++l) xdut->a[l] = a[(i + l) % n];
+        xdut->eval();
+        acc += xdut->y[0] + xdut->exc_inexact;
+      }
+      sink = sink + acc;
+    });
+#endif
+    double sf_ns = tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      reference_sqrt_batch(RefBackend::SoftFloat, a.data(), ref.data(), n);
+    });
+    double model_ns = tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      reference_sqrt_batch(RefBackend::Model, a.data(), ref.data(), n);
+    });
+    double host_ns = tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      reference_sqrt_batch(RefBackend::Host, a.data(), ref.data(), n);
+    });
+    double golden_ns = golden_table.is_open() ? tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      reference_sqrt_batch(RefBackend::Golden, a.data(), ref.data(), n);
+    }) : 0.0;
+    bool all_pass = true;
+    double check_ns = tb::time_ns_per_vector(n, BENCH_REPEATS, [&] {
+      for (size_t i = 0; i < n; ++i) all_pass &= compare_with_softfloat(bdut.get(), a[i], i, false, &ref[i]);
+    });
+    if (!all_pass) {
+      std::cout << "ERROR: mismatch while benchmarking region " << region.name << std::endl;
+      return 1;
+    }
+
+    report.add(region.name, "gen", gen_ns);
+    report.add(region.name, "eval", eval_ns);
+#ifdef TB_LANES
+    report.add(region.name, "eval_x" + std::to_string(TB_LANES), eval_xn_ns);
+#endif
+    report.add(region.name, "ref_softfloat", sf_ns);
+    report.add(region.name, "ref_model", model_ns);
+    report.add(region.name, "ref_host", host_ns);
+    if (golden_table.is_open()) report.add(region.name, "ref_golden", golden_ns);
+    report.add(region.name, "check", check_ns);
+  }
+  bdut->final();
+#ifdef TB_LANES
+  xdut->final();
+#endif
+
+  if (!report.write(out_path)) {
+    std::cout << "ERROR: cannot write " << out_path << std::endl;
+    return 1;
+  }
+  std::cout << "Results appended to " << out_path << std::endl;
+  if (!baseline_path.empty() && !report.check_baseline(baseline_path, tolerance_pct)) return 1;
+  return 0;
+}
 
 int main(int argc, char **argv) {
-  // Parse command line arguments for verbose mode
+  // Parse command line arguments
   bool verbose = false;
+  bool exhaustive = false;
+  std::string checkpoint_path = Exhaustive::DEFAULT_CHECKPOINT;
+  long requested_jobs = 1;
+  bool ref_given = false;
+  RefBackend random_backend = RefBackend::Model;
+  std::string golden_path = DEFAULT_GOLDEN_TABLE;
+  std::string corpus_path = DEFAULT_CORPUS;
+  std::string settings_path = DEFAULT_SETTINGS;
+  std::vector<std::vector<std::string>> overrides;  // settings given on the command line
+  bool seed_given = false;
+  uint64_t seed = 0;
+  bool replay = false;
+  uint64_t replay_index = 0;
+  bool bench = false;
+  std::string bench_out = "bench_output.txt";
+  std::string bench_baseline;
+  double bench_tolerance = 25.0;
+  bool coverage_enabled = true;
+  std::string coverage_out;
+  bool keep_going = false;
+  bool lockstep = false;
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
       verbose = true;
+    } else if (strcmp(argv[i], "--ref") == 0 && i + 1 < argc) {
+      ++i;
+      ref_given = true;
+      if (strcmp(argv[i], "softfloat") == 0) {
+        random_backend = RefBackend::SoftFloat;
+      } else if (strcmp(argv[i], "model") == 0) {
+        random_backend = RefBackend::Model;
+      } else if (strcmp(argv[i], "host") == 0) {
+        random_backend = RefBackend::Host;
+      } else if (strcmp(argv[i], "golden") == 0) {
+        random_backend = RefBackend::Golden;
+      } else {
+        std::cout << "ERROR: unknown reference backend '" << argv[i] << "'" << std::endl;
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--exhaustive") == 0) {
+      exhaustive = true;
+    } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+      checkpoint_path = argv[++i];
+    } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+      requested_jobs = strtol(argv[++i], nullptr, 0);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = strtoull(argv[++i], nullptr, 0);
+      seed_given = true;
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      if (!tb::parse_replay(argv[++i], seed, replay_index)) {
+        std::cout << "ERROR: --replay expects seed:index, got '" << argv[i] << "'" << std::endl;
+        return 1;
+      }
+      replay = true;
+    } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+      golden_path = argv[++i];
+    } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+      corpus_path = argv[++i];
+    } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+      settings_path = argv[++i];
+    } else if (strcmp(argv[i], "--corners") == 0 && i + 1 < argc) {
+      overrides.push_back({"corner_file", argv[++i]});
+    } else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--random-tests") == 0) && i + 1 < argc) {
+      overrides.push_back({"random_tests", argv[++i]});
+    } else if (strcmp(argv[i], "--validation-tests") == 0 && i + 1 < argc) {
+      overrides.push_back({"validation_tests", argv[++i]});
+    } else if (strcmp(argv[i], "--subnorm-step") == 0 && i + 1 < argc) {
+      overrides.push_back({"subnorm_step", argv[++i]});
+    } else if (strcmp(argv[i], "--boundary-range") == 0 && i + 1 < argc) {
+      overrides.push_back({"boundary_range", argv[++i]});
+    } else if (strcmp(argv[i], "--hard-tests") == 0 && i + 1 < argc) {
+      overrides.push_back({"hard_tests", argv[++i]});
+    } else if (strcmp(argv[i], "--metamorphic") == 0 && i + 1 < argc) {
+      overrides.push_back({"metamorphic", argv[++i]});
+    } else if (strcmp(argv[i], "--weight") == 0 && i + 1 < argc) {
+      std::string arg = argv[++i];
+      size_t eq = arg.find('=');
+      overrides.push_back({"weight", arg.substr(0, eq), eq == std::string::npos ? "" : arg.substr(eq + 1)});
+    } else if (strcmp(argv[i], "--no-coverage") == 0) {
+      coverage_enabled = false;
+    } else if (strcmp(argv[i], "--keep-going") == 0) {
+      keep_going = true;
+    } else if (strcmp(argv[i], "--lockstep") == 0) {
+      lockstep = true;
+    } else if (strcmp(argv[i], "--coverage-out") == 0 && i + 1 < argc) {
+      coverage_out = argv[++i];
+    } else if (strcmp(argv[i], "--bench") == 0) {
+      bench = true;
+    } else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) {
+      bench_out = argv[++i];
+    } else if (strcmp(argv[i], "--bench-baseline") == 0 && i + 1 < argc) {
+      bench_baseline = argv[++i];
+    } else if (strcmp(argv[i], "--bench-tolerance") == 0 && i + 1 < argc) {
+      bench_tolerance = strtod(argv[++i], nullptr);
     }
   }
+  unsigned jobs = tb::resolve_jobs(requested_jobs);
+  if (jobs > 1 && !tb::softfloat_thread_safe()) {
+    std::cout << "WARNING: SoftFloat not built with THREAD_LOCAL; running single-threaded" << std::endl;
+    jobs = 1;
+  }
   
-  // seed random for varied FP32 inputs
-  srand(static_cast<unsigned>(time(nullptr)));
-
   Verilated::commandArgs(argc, argv);
 
+  // The golden table is mapped when selected as reference; benchmarks use it
+  // whenever it is present
+  if (random_backend == RefBackend::Golden || bench) {
+    std::string error;
+    if (!golden_table.open(golden_path, &error) && random_backend == RefBackend::Golden && !bench) {
+      std::cout << "ERROR: " << error << " (generate it with make sqrt_golden)" << std::endl;
+      return 1;
+    }
+  }
+
+  // Benchmark mode measures stage costs only; it does not run the test phases
+  if (bench) return run_bench(bench_out, bench_baseline, bench_tolerance);
+
+  // Test counts and region weights: settings file, then command-line overrides
+  TestSettings settings;
+  if (!load_test_settings(settings_path, overrides, settings)) return 1;
+
+  // Replay regenerates one random vector from its seed and index and checks
+  // it against SoftFloat with a full report
+  if (replay) {
+    std::unique_ptr<Vfp32_sqrt_comb> rdut(new Vfp32_sqrt_comb());
+    std::cout << "Replay: seed 0x" << std::hex << seed << std::dec << " index " << replay_index << std::endl;
+    uint32_t replay_a = random_vector(seed, replay_index);
+    bool pass = compare_with_softfloat(rdut.get(), replay_a, replay_index, true);
+    uint64_t variants = 0;
+    if (pass && settings.metamorphic) {
+      pass = check_variants(rdut.get(), seed, replay_index, replay_a, softfloat_sqrt(replay_a), settings.metamorphic,
+                            true, variants);
+    }
+    rdut->final();
+    return pass ? 0 : 1;
+  }
+
+  tb::MismatchClusters mismatch_classes;
+  if (keep_going) {
+    mismatches = &mismatch_classes;
+    std::cout << "Keep going: mismatches are classified and summarized at the end" << std::endl;
+  }
+
+  // Lockstep mode sweeps every input through the DUT and the reference RTL
+  if (lockstep) {
+#ifdef TB_LOCKSTEP
+    failure_corpus.load(corpus_path);
+    return run_lockstep(jobs);
+#else
+    std::cout << "ERROR: --lockstep needs a lockstep build (make sqrt_lockstep)" << std::endl;
+    return 1;
+#endif
+  }
+
+  // Exhaustive mode replaces the sampled phases entirely. It proves the RTL
+  // against SoftFloat itself unless a faster backend is requested explicitly.
+  if (exhaustive) {
+    if (!ref_given) random_backend = RefBackend::SoftFloat;
+    if (random_backend != RefBackend::SoftFloat &&
+        !validate_reference_backend(random_backend, jobs, settings.validation_tests)) {
+      std::cout << "Reference backend disagrees with SoftFloat; rerun with --ref softfloat" << std::endl;
+      return 1;
+    }
+    reference_backend = random_backend;
+    failure_corpus.load(corpus_path);
+    return run_exhaustive(jobs, checkpoint_path, verbose, coverage_enabled, coverage_out);
+  }
+
+  // Seed for the stratified random phase; printed so any vector can be replayed
+  if (!seed_given) seed = tb::random_seed();
+  std::cout << "Settings: " << settings_path << " (" << settings.random_tests << " random vectors)" << std::endl;
+  std::cout << "Seed: 0x" << std::hex << seed << std::dec << std::endl;
+
   Vfp32_sqrt_comb *dut = new Vfp32_sqrt_comb();
 
+  // Coverage of the corner-case, systematic and random phases
+  tb::Coverage coverage = make_sqrt_coverage();
+
   // Variables for coverage tracking
+  int num_corpus = 0;
   int num_cc = 0;
   int systematic_tests = 0;
-  
-  // Stratified random testing - divide FP32 space into regions
-  struct TestRegion {
-    uint32_t start, end;
-    const char* name;
-    int weight;
-  };
-  
-  TestRegion regions[] = {
-    {0x00000000, 0x00800000, "subnormals", 15},         // More weight for sqrt edge cases
-    {0x00800000, 0x34000000, "small_normals", 10},
-    {0x34000000, 0x3f000000, "medium_normals", 8},
-    {0x3f000000, 0x40800000, "near_one", 20},          // Critical for sqrt accuracy
-    {0x40800000, 0x7f000000, "large_normals", 12},
-    {0x7f000000, 0x7f800000, "near_overflow", 10},
-    {0x7f800000, 0x7fffffff, "special_values", 15},     // inf, NaN cases
-    // Negative values all produce NaN for sqrt, but still test
-    {0x80000000, 0x80000000, "neg_zero", 5},            // -0 -> -0
-    {0x80000001, 0xffffffff, "negative_vals", 5}        // All other negatives -> NaN
-  };
-  
-  //const int TOTAL_STRATIFIED_TESTS = 1000000;
-  const int TOTAL_STRATIFIED_TESTS = 60000000;
-  int total_weight = 0;
-  for (auto& region : regions) total_weight += region.weight;
+  uint64_t hard_tests = 0;
 
+  // === Failure corpus replay ===
+  // Inputs that failed in earlier runs are checked first, so a regression
+  // they caught is reported before any other phase runs
+  if (!corpus_path.empty()) {
+    if (!failure_corpus.load(corpus_path)) {
+      std::cout << "WARNING: skipped malformed lines in " << corpus_path << std::endl;
+    }
+    num_corpus = static_cast<int>(failure_corpus.entries().size());
+    std::cout << "=== Failure corpus replay (" << num_corpus << " vectors from " << corpus_path << ") ===" << std::endl;
+    for (int i = 0; i < num_corpus; ++i) {
+      if (!compare_with_softfloat(dut, failure_corpus.entries()[i][0], i, verbose) &&
+          !on_mismatch(dut, failure_corpus.entries()[i][0], "corpus", false)) {
+        dut->final();
+        delete dut;
+        return 1;
+      }
+    }
+  }
+  
   // === Corner-case tests for sqrt ===
   {
     union {
       float f;
       uint32_t u;
     } conv_cc, out_cc, math_cc;
-    static const uint32_t corner_vals[] = {
-        // === Basic special values ===
-        0x00000000, // +0 -> +0 (exact)
-        0x80000000, // -0 -> -0 (exact)
-        0x3f800000, // 1.0 -> 1.0 (exact)
-        0x7f800000, // +inf -> +inf
-        0xff800000, // -inf -> NaN (invalid)
-        0x7fc00000, // qNaN -> qNaN
-        0x7fa00000, // sNaN -> qNaN (invalid)
-        0xbf800000, // -1.0 -> NaN (invalid)
-        0x80000001, // -min_subnormal -> NaN (invalid)
-        0x80800000, // -min_normal -> NaN (invalid)
-        0xff7fffff, // -max_finite -> NaN (invalid)
-        
-        // === Subnormal boundaries ===
-        0x00000001, // min subnormal -> very small
-        0x00000002, // 2*min subnormal
-        0x00000004, // 4*min subnormal  
-        0x00000100, // medium subnormal
-        0x007fffff, // max subnormal
-        0x00800000, // min normal
-        0x00800001, // just above min normal
-        0x00800100, // slightly above min normal
-        
-        // === Perfect squares ===
-        0x40000000, // 2.0 -> sqrt(2) ≈ 1.414... (inexact)
-        0x40800000, // 4.0 -> 2.0 (exact)
-        0x41100000, // 9.0 -> 3.0 (exact)
-        0x41800000, // 16.0 -> 4.0 (exact)
-        0x42480000, // 50.0 -> sqrt(50) ≈ 7.071... (inexact)
-        0x42c80000, // 100.0 -> 10.0 (exact)
-        0x447a0000, // 1000.0 -> sqrt(1000) ≈ 31.622... (inexact)
-        0x461c4000, // 10000.0 -> 100.0 (exact)
-        0x4b000000, // 2^23 -> sqrt(2^23) = 2^11.5 (inexact)
-        0x4c000000, // 2^24 -> 2^12 = 4096.0 (exact)
-        
-        // === Powers of 2 (should be exact or simple) ===
-        0x3e800000, // 0.25 -> 0.5 (exact)
-        0x3f000000, // 0.5 -> sqrt(0.5) ≈ 0.707... (inexact)
-        0x3f800000, // 1.0 -> 1.0 (exact)
-        0x40000000, // 2.0 -> sqrt(2) ≈ 1.414... (inexact)
-        0x40800000, // 4.0 -> 2.0 (exact)
-        0x41000000, // 8.0 -> sqrt(8) ≈ 2.828... (inexact)
-        0x41800000, // 16.0 -> 4.0 (exact)
-        0x42000000, // 32.0 -> sqrt(32) ≈ 5.656... (inexact)
-        
-        // === Boundary values ===
-        0x7f7fffff, // max finite -> very large result
-        0x3f7fffff, // just below 1.0
-        0x3f800001, // just above 1.0
-        0x007fffff, // max subnormal
-        0x00800000, // min normal
-        0x34000000, // small normal value
-        0x7f000000, // large value near overflow
-        
-        // === Rounding-critical values ===
-        0x3f490fdb, // π/2 ≈ 1.5708 -> sqrt(π/2) (inexact)
-        0x40490fdb, // π ≈ 3.14159 -> sqrt(π) (inexact)
-        0x402df854, // e ≈ 2.71828 -> sqrt(e) (inexact)
-        0x40c90fdb, // 2π ≈ 6.28318 -> sqrt(2π) (inexact)
-        0x3eaaaaab, // 1/3 ≈ 0.333... -> sqrt(1/3) (inexact)
-        0x3f2aaaab, // 2/3 ≈ 0.666... -> sqrt(2/3) (inexact)
-        
-        // === Tie-to-even rounding cases ===
-        0x3f800100, // slightly above 1.0 (tie case potential)
-        0x3f800200, // slightly above 1.0 (tie case potential)
-        0x3f800300, // slightly above 1.0 (tie case potential)
-        0x40000100, // slightly above 2.0 (tie case potential)
-        0x40000200, // slightly above 2.0 (tie case potential)
-        
-        // === Algorithm stress tests ===
-        0x33800000, // very small normal (stress subnormal output)
-        0x4f800000, // large value (stress normalization)
-        0x70000000, // very large (near overflow boundary)
-        0x0f800000, // small value (many leading zeros)
-        0x08000000, // very small (extreme subnormal input)
-        
-        // === Square root algorithm edge cases ===
-        0x3f400000, // 0.75 -> sqrt(0.75) ≈ 0.866... (test quotient selection)
-        0x3fc00000, // 1.5 -> sqrt(1.5) ≈ 1.224... (test quotient selection)
-        0x40200000, // 2.5 -> sqrt(2.5) ≈ 1.581... (test quotient selection)
-        0x40600000, // 3.5 -> sqrt(3.5) ≈ 1.870... (test quotient selection)
-        0x40a00000, // 5.0 -> sqrt(5) ≈ 2.236... (test quotient selection)
-        0x40e00000, // 7.0 -> sqrt(7) ≈ 2.645... (test quotient selection)
-        
-        // === Guard/round/sticky boundary tests ===
-        0x3f800001, // epsilon above 1.0 -> test guard bit
-        0x3f800003, // 3*epsilon above 1.0 -> test round bit
-        0x3f800007, // 7*epsilon above 1.0 -> test sticky bit
-        0x3f80000f, // 15*epsilon above 1.0 -> multiple sticky bits
-        0x40000001, // epsilon above 2.0 -> test guard bit
-        0x40000003, // 3*epsilon above 2.0 -> test round bit
-        
-        // === Previously observed failure cases ===
-        0x40e4006e, // 7.12505 (observed failure)
-        0x016f609c, // 4.39667e-38 (observed failure)
-        0x2812c1b1, // 8.14663e-15 (observed failure)
-        0x67bee97d, // 1.80311e+24 (observed failure)
-        0x1ab82050, // 7.61528e-23 (observed failure)
-        0x59042172, // 2.32447e+15 (observed failure)
-        0x321bbcdd, // 9.06513e-09 (observed failure)
-        0x36a9405f, // 5.04409e-06
-        0x3fab6860, // 1.33912
-        0x72cb1062, // 8.04419e+30
-        0x6e002f83, // 9.91788e+27
-        0x2605ba5a, // 4.63962e-16
-        0x429850b4, // 76.1576
-        0x696c0b48, // 1.7835e+25
-        0x01cdf635, // 7.56584e-38
-        0x4b975f95, // 1.98408e+07
-        0x3b2c6f35, // 0.00263114
-        
-        // === Square root of small fractions ===
-        0x3d800000, // 0.0625 -> 0.25 (exact)
-        0x3e000000, // 0.125 -> sqrt(0.125) ≈ 0.353... (inexact)
-        0x3e800000, // 0.25 -> 0.5 (exact)
-        0x3ec00000, // 0.375 -> sqrt(0.375) ≈ 0.612... (inexact)
-        0x3f000000, // 0.5 -> sqrt(0.5) ≈ 0.707... (inexact)
-        
-        // === Underflow boundary tests ===
-        0x00000010, // small subnormal -> extreme underflow result
-        0x00001000, // medium subnormal
-        0x00010000, // larger subnormal
-        0x00100000, // near-normal subnormal
-        0x007f0000, // large subnormal
-        
-        // === Iterator convergence edge cases ===
-        0x7f000000, // large input (test convergence speed)
-        0x01000000, // tiny input (test convergence accuracy)
-        0x7e000000, // near-overflow input
-        0x02000000, // small input requiring many iterations
-        
-        // === Mantissa bit patterns that stress algorithm ===
-        0x3f800000, // 1.0 (mantissa = 0)
-        0x3fc00000, // 1.5 (mantissa = 0x400000)
-        0x3fe00000, // 1.75 (mantissa = 0x600000)
-        0x3ff00000, // 1.875 (mantissa = 0x700000)
-        0x3ff80000, // 1.9375 (mantissa = 0x780000)
-        0x3ffc0000, // 1.96875 (mantissa = 0x7c0000)
-        0x3ffe0000, // 1.984375 (mantissa = 0x7e0000)
-        0x3fff0000, // 1.9921875 (mantissa = 0x7f0000)
-    };
-    num_cc = sizeof(corner_vals) / sizeof(corner_vals[0]);
+    // Inputs are read from the corner-case file (see sqrt_corner_cases.txt)
+    std::vector<std::vector<uint32_t>> corner_vals;
+    unsigned bad_line = 0;
+    if (!tb::load_vectors(settings.corner_file, 1, corner_vals, &bad_line)) {
+      std::cout << "ERROR: cannot read corner cases from " << settings.corner_file;
+      if (bad_line) std::cout << " (malformed line " << bad_line << ")";
+      std::cout << std::endl;
+      dut->final();
+      delete dut;
+      return 1;
+    }
+    num_cc = static_cast<int>(corner_vals.size());
     for (int i = 0; i < num_cc; ++i) {
-      conv_cc.u = corner_vals[i];
+      conv_cc.u = corner_vals[i][0];
       dut->a = conv_cc.u;
       dut->eval();
       out_cc.u = dut->y;
@@ -240,7 +1203,7 @@ int main(int argc, char **argv) {
       bool flags_pass_cc = (dut_flags_cc == math_flags_cc);
       bool overall_pass_cc = pass_cc && flags_pass_cc;
       // print only failures or verbose mode
-      if (!overall_pass_cc || verbose) {
+      if ((!overall_pass_cc && (!mismatches || mismatches->claim_report())) || verbose) {
         std::cout << "[SQRT CASE " << i << "] a=" << conv_cc.f
                   << " | rtl=" << out_cc.f << " math=" << math_cc.f
                   << " | ulp_diff=" << ulp_diff_cc
@@ -248,11 +1211,12 @@ int main(int argc, char **argv) {
                   << std::hex << math_flags_cc << " rtl=0x" << dut_flags_cc
                   << std::dec << (flags_pass_cc ? "" : " FLAG_FAIL") << std::endl;
       }
-      if (!overall_pass_cc) {
+      if (!overall_pass_cc && !on_mismatch(dut, conv_cc.u, "corner", false)) {
         dut->final();
         delete dut;
         return 1;
       }
+      if (coverage_enabled) coverage.hit(sqrt_coverage_bin(coverage, dut));
     }
     std::cout << "=== Sqrt corner-case tests done ===" << std::endl;
   }
@@ -261,7 +1225,8 @@ int main(int argc, char **argv) {
   std::cout << "=== Systematic boundary testing ===" << std::endl;
   
   // Test all subnormal inputs
-  for (uint32_t subnormal = 0x00000001; subnormal <= 0x007fffff; subnormal += 0x00001111) {
+  for (uint64_t step_sub = 0x00000001; step_sub <= 0x007fffff; step_sub += settings.subnorm_step) {
+    uint32_t subnormal = static_cast<uint32_t>(step_sub);
     dut->a = subnormal;
     dut->eval();
     
@@ -277,7 +1242,7 @@ int main(int argc, char **argv) {
     
     bool result_match = (dut->y == r_sf.v);
     bool flags_match = (dut_flags == math_flags);
-    if (!result_match || !flags_match) {
+    if ((!result_match || !flags_match) && (!mismatches || mismatches->claim_report())) {
       union { float f; uint32_t u; } a_union = {.u = subnormal};
       union { float f; uint32_t u; } rtl_union = {.u = dut->y};
       union { float f; uint32_t u; } math_union = {.u = r_sf.v};
@@ -287,15 +1252,20 @@ int main(int argc, char **argv) {
                 << " math=0x" << std::setw(8) << std::setfill('0') << r_sf.v
                 << " math_flags=0x" << math_flags
                 << " rtl_flags=0x" << dut_flags << std::dec << std::endl;
+    }
+    if ((!result_match || !flags_match) && !on_mismatch(dut, subnormal, "systematic")) {
       dut->final();
       delete dut;
       return 1;
     }
+    if (coverage_enabled) coverage.hit(sqrt_coverage_bin(coverage, dut));
     systematic_tests++;
   }
   
   // Test boundary values around 1.0 (critical for sqrt accuracy)
-  for (uint32_t near_one = 0x3f7ff000; near_one <= 0x3f801000; near_one++) {
+  uint32_t boundary_first = 0x3f800000 - static_cast<uint32_t>(settings.boundary_range / 2);
+  for (uint32_t i = 0; i < settings.boundary_range; ++i) {
+    uint32_t near_one = boundary_first + i;
     dut->a = near_one;
     dut->eval();
     
@@ -308,141 +1278,182 @@ int main(int argc, char **argv) {
                         (dut->exc_overflow << 2) | (dut->exc_underflow << 1) |
                         (dut->exc_inexact);
     
-    if (dut->y != r_sf_bnd.v || dut_flags_bnd != math_flags_bnd) {
+    bool boundary_pass = dut->y == r_sf_bnd.v && dut_flags_bnd == math_flags_bnd;
+    if (!boundary_pass && (!mismatches || mismatches->claim_report())) {
       std::cout << "[SQRT BOUNDARY] FAIL: a=0x" << std::hex << std::setw(8) << std::setfill('0') << near_one
                 << " rtl=0x" << std::setw(8) << std::setfill('0') << dut->y
                 << " math=0x" << std::setw(8) << std::setfill('0') << r_sf_bnd.v
                 << " rtl_flags=0x" << dut_flags_bnd
                 << " math_flags=0x" << math_flags_bnd << std::dec << std::endl;
+    }
+    if (!boundary_pass && !on_mismatch(dut, near_one, "boundary")) {
       dut->final();
       delete dut;
       return 1;
     }
+    if (coverage_enabled) coverage.hit(sqrt_coverage_bin(coverage, dut));
     systematic_tests++;
   }
   
   std::cout << "Systematic tests completed: " << systematic_tests << std::endl;
+
+  // === Hard-to-round tests ===
+  // Roots just above or below a rounding midpoint or a representable value,
+  // then every input with an exact root; always checked against SoftFloat.
+  // Drawn from the inverted seed so they do not repeat the random phase's streams.
+  std::cout << "=== Hard-to-round tests ===" << std::endl;
+  std::vector<uint32_t> hard_inputs = tb::exact_squares();
+  for (uint64_t i = 0; i < settings.hard_tests; ++i) {
+    tb::VectorRng rng(~seed, i);
+    uint32_t hard_a;
+    if (tb::hard_sqrt_input(rng, hard_a)) hard_inputs.push_back(hard_a);
+  }
+  for (size_t i = 0; i < hard_inputs.size(); ++i) {
+    if (!compare_with_softfloat(dut, hard_inputs[i], i, verbose) && !on_mismatch(dut, hard_inputs[i], "hard")) {
+      dut->final();
+      delete dut;
+      return 1;
+    }
+    if (coverage_enabled) coverage.hit(sqrt_coverage_bin(coverage, dut));
+    hard_tests++;
+  }
+  std::cout << "Hard-to-round tests completed: " << hard_tests << std::endl;
   
+  // === Reference backend validation ===
+  // Corner and systematic phases always use SoftFloat; the random phase may
+  // switch to a faster backend once it has been shown to agree with SoftFloat.
+  if (random_backend != RefBackend::SoftFloat) {
+    std::cout << "=== Reference backend validation ===" << std::endl;
+    if (!validate_reference_backend(random_backend, jobs, settings.validation_tests)) {
+      std::cout << "Reference backend disagrees with SoftFloat; rerun with --ref softfloat" << std::endl;
+      dut->final();
+      delete dut;
+      return 1;
+    }
+    std::cout << "Backend matches SoftFloat on " << settings.validation_tests << " vectors" << std::endl;
+  }
+  reference_backend = random_backend;
+
   // === Stratified Random Testing ===
   std::cout << "=== Stratified random testing ===" << std::endl;
-  
-  // Use multiple PRNG states for better coverage
-  std::random_device rd;
-  std::mt19937 gen1(rd());
-  std::mt19937 gen2(rd() + 12345);
-  std::uniform_int_distribution<uint32_t> dis(0, 0xFFFFFFFF);
-
-  while (time_counter < TOTAL_STRATIFIED_TESTS) {
-    // Select region based on weighted probability
-    int region_select = dis(gen1) % total_weight;
-    int current_weight = 0;
-    TestRegion* selected_region = nullptr;
-    
-    for (auto& region : regions) {
-      current_weight += region.weight;
-      if (region_select < current_weight) {
-        selected_region = &region;
-        break;
+  std::cout << "Worker threads: " << jobs << std::endl;
+  std::cout << "Reference: " << backend_name(reference_backend) << std::endl;
+#ifdef TB_LANES
+  std::cout << "Lanes per eval(): " << TB_LANES << std::endl;
+#endif
+
+  // Shard the vector index space across workers. Each worker owns its own
+  // Verilated model; vectors come from (seed, index), so only the stop flag
+  // is shared.
+  tb::Stopwatch random_timer;
+  std::vector<tb::Coverage> worker_coverage(jobs, make_sqrt_coverage());
+  std::vector<uint64_t> worker_variants(jobs, 0);
+  tb::ShardResult random_result = tb::run_sharded(jobs, settings.random_tests,
+      [&](unsigned worker, uint64_t begin, uint64_t end, std::atomic<bool>& stop) {
+    tb::ShardResult shard;
+    tb::Coverage& wcov = worker_coverage[worker];
+    std::unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+    std::unique_ptr<Vfp32_sqrt_comb> wdut(new Vfp32_sqrt_comb(contextp.get()));
+#ifdef TB_LANES
+    std::unique_ptr<Vfp32_sqrt_comb_xN> xdut(new Vfp32_sqrt_comb_xN(contextp.get()));
+#endif
+
+    // Block pipeline over REF_BATCH vectors: generate all inputs, run all DUT
+    // evals, run all reference computations, then compare the result and
+    // flag arrays in one pass. Only mismatching indices are formatted.
+    uint32_t block_a[REF_BATCH];
+    uint32_t block_y[REF_BATCH];
+    uint8_t block_flags[REF_BATCH];
+    fp32_ref::Result block_ref[REF_BATCH];
+    uint32_t block_bad[REF_BATCH];
+
+    for (uint64_t block = begin; block < end; block += REF_BATCH) {
+      // Poll for failures in other workers
+      if (stop.load(std::memory_order_relaxed)) break;
+      size_t n = static_cast<size_t>(std::min<uint64_t>(REF_BATCH, end - block));
+
+      random_block(seed, block, n, block_a);
+
+#ifdef TB_LANES
+      for (size_t i = 0; i < n; i += TB_LANES) {
+        eval_lanes(xdut.get(), block_a + i, std::min<size_t>(TB_LANES, n - i), block_y + i, block_flags + i);
       }
-    }
-    
-    if (!selected_region) selected_region = &regions[0]; // fallback
-    
-    // Generate random value within selected region
-    uint32_t rand_bits;
-    if (selected_region->start == selected_region->end) {
-      rand_bits = selected_region->start;  // Single value (like -0)
-    } else {
-      uint64_t range = (uint64_t)selected_region->end - selected_region->start;
-      if (range > 0) {
-        rand_bits = selected_region->start + (dis(gen2) % (range + 1));
-      } else {
-        rand_bits = selected_region->start;
+      // The wrapper has no debug ports: sample coverage on the scalar model
+      for (size_t i = 0; coverage_enabled && i < n; ++i) {
+        wdut->a = block_a[i];
+        wdut->eval();
+        wcov.hit(sqrt_coverage_bin(wcov, wdut.get()), block + i);
       }
-    }
-    
-    union {
-      float f;
-      uint32_t u;
-    } conv;
-    conv.u = rand_bits;
-    dut->a = conv.u;
-    dut->eval(); // Evaluate the design
-
-    // Convert the output back to float
-    union {
-      uint32_t u;
-      float f;
-    } out_conv;
-    out_conv.u = dut->y;
+#else
+      for (size_t i = 0; i < n; ++i) {
+        wdut->a = block_a[i];
+        wdut->eval();
+        block_y[i] = wdut->y;
+        block_flags[i] = (wdut->exc_invalid << 4) | (wdut->exc_divzero << 3) | (wdut->exc_overflow << 2) |
+                         (wdut->exc_underflow << 1) | wdut->exc_inexact;
+        if (coverage_enabled) wcov.hit(sqrt_coverage_bin(wcov, wdut.get()), block + i);
+      }
+#endif
 
-    // clear FP exceptions and reference sqrt via SoftFloat
-    softfloat_exceptionFlags = 0;
-    float32_t a_sf;
-    a_sf.v = conv.u;
-    float32_t r_sf = f32_sqrt(a_sf);
-    int math_flags = softfloat_exceptionFlags;
-    union {
-      uint32_t u;
-      float f;
-    } math_conv;
-    math_conv.u = r_sf.v;
-
-    // ULP diff - use unsigned comparison for correct handling of negative numbers
-    uint32_t ulp_diff;
-    if (out_conv.u == math_conv.u) {
-      ulp_diff = 0;
-    } else if ((out_conv.u ^ math_conv.u) & 0x80000000) {
-      // Different signs - handle zero crossing case
-      ulp_diff = (out_conv.u & 0x7FFFFFFF) + (math_conv.u & 0x7FFFFFFF);
-    } else {
-      // Same sign - simple unsigned difference
-      ulp_diff = (out_conv.u > math_conv.u) ? (out_conv.u - math_conv.u) : (math_conv.u - out_conv.u);
-    }
-    // collect RTL exception flags and compare
-    int dut_flags = (dut->exc_invalid << 4) | (dut->exc_divzero << 3) |
-                    (dut->exc_overflow << 2) | (dut->exc_underflow << 1) |
-                    (dut->exc_inexact);
-    bool flag_pass = (dut_flags == math_flags);
-
-    // If both outputs are NaN, consider as PASS
-    bool is_nan_case = std::isnan(math_conv.f) && std::isnan(out_conv.f);
-    // strict match: NaN bit patterns must match exactly (including payload)
-    bool pass = is_nan_case ? (out_conv.u == math_conv.u) : (ulp_diff == 0);
-    bool overall_pass = pass && flag_pass;
-
-    // Print only failures or verbose mode
-    if (!overall_pass || verbose) {
-      std::cout << "Time: " << time_counter << " | sqrt_in: " << conv.f
-                << " (bits=0x" << std::hex << std::setw(8) << std::setfill('0')
-                << conv.u << std::dec << ")" << " | sqrt_out(rtl): " << out_conv.f
-                << " (bits=0x" << std::hex << std::setw(8) << std::setfill('0')
-                << out_conv.u << std::dec << ")"
-                << " | sqrt_out(math): " << math_conv.f << " (bits=0x" << std::hex
-                << std::setw(8) << std::setfill('0') << math_conv.u << std::dec
-                << ")" << " | ulp_diff: " << ulp_diff
-                << (pass ? " PASS" : " FAIL")
-                << " | FLAG=" << (flag_pass ? " PASS" : " FAIL")
-                << " | math_flags=0x" << std::hex << math_flags << std::dec
-                << " | dut_flags=0x" << std::hex << dut_flags << std::dec
-                << std::endl;
-    }
+      reference_sqrt_batch(reference_backend, block_a, block_ref, n);
 
-    if (!overall_pass) {
-      dut->final();
-      delete dut;
-      return 1;
+      size_t bad = block_candidates(block_y, block_flags, block_ref, n, verbose, block_bad);
+      size_t passed = n;
+      unsigned mismatched = 0;
+      for (size_t k = 0; k < bad; ++k) {
+        size_t i = block_bad[k];
+        if (!check_input(wdut.get(), block_a[i], block_ref[i], block_y[i], block_flags[i], block + i, verbose,
+                         "random", &seed, mismatched)) {
+          // Stop this worker (and signal the others) on failure
+          shard.failed = true;
+          passed = i;
+          break;
+        }
+      }
+      for (size_t i = 0; settings.metamorphic && i < passed && !shard.failed; ++i) {
+        if (!check_variants(wdut.get(), seed, block + i, block_a[i], block_ref[i], settings.metamorphic, verbose,
+                            worker_variants[worker])) {
+          shard.failed = true;
+          passed = i + 1;
+        }
+      }
+      shard.tested += passed;
+      if (shard.failed) break;
     }
-
-    time_counter++;
+#ifdef TB_LANES
+    xdut->final();
+#endif
+    wdut->final();
+    return shard;
+  });
+  double random_seconds = random_timer.seconds();
+  time_counter = random_result.tested;
+  uint64_t variants = 0;
+  for (uint64_t v : worker_variants) variants += v;
+  if (random_result.failed) {
+    dut->final();
+    delete dut;
+    return 1;
+  }
+  std::cout << "Random throughput: " << std::fixed << std::setprecision(0)
+            << (random_result.tested / (random_seconds > 0 ? random_seconds : 1)) << " vectors/s ("
+            << std::setprecision(2) << random_seconds << " s)" << std::endl;
+  if (settings.metamorphic) {
+    std::cout << "Metamorphic variants: " << variants << " (" << std::setprecision(2)
+              << (time_counter ? static_cast<double>(variants) / time_counter : 0.0)
+              << " per random vector)" << std::endl;
   }
 
   // === Coverage analysis and reporting ===
   std::cout << "\n=== Test Coverage Summary ===" << std::endl;
+  std::cout << "Corpus vectors: " << num_corpus << std::endl;
   std::cout << "Corner cases: " << num_cc << std::endl;
   std::cout << "Systematic tests: " << systematic_tests << std::endl;
+  std::cout << "Hard-to-round tests: " << hard_tests << std::endl;
   std::cout << "Stratified random tests: " << time_counter << std::endl;
-  std::cout << "Total test vectors: " << (num_cc + systematic_tests + time_counter) << std::endl;
+  std::cout << "Metamorphic variants: " << variants << std::endl;
+  std::cout << "Total test vectors: "
+            << (num_corpus + num_cc + systematic_tests + hard_tests + time_counter + variants) << std::endl;
   
   // Print region coverage statistics
   std::cout << "\n=== Random Test Distribution ===" << std::endl;
@@ -452,7 +1463,14 @@ int main(int argc, char **argv) {
               << percentage << "%" << std::endl;
   }
 
+  // Coverage of all phases: unreached bins tell which cases the vector mix misses
+  if (coverage_enabled) report_coverage(coverage, worker_coverage, coverage_out);
+
   dut->final();
   delete dut; // Clean up the allocated memory
+  if (mismatches && mismatches->total()) {
+    mismatches->report();
+    return 1;
+  }
   return 0;
 }
@@ -0,0 +1,175 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    tb_hard_cases.h
+ * @brief   Hard-to-round operand construction for division and square root
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Random operands almost never give a result within a tiny fraction of an
+ * ulp of a rounding midpoint (or of a representable value), where the
+ * guard/round/sticky logic decides the result. These generators construct
+ * such operands directly:
+ *
+ * - Division: for 24-bit significands ma, mb (mb odd) and a small nonzero r,
+ *   ma * 2^k = mb * Q + r  <=>  ma = r * 2^-k (mod mb).
+ *   Q is the result truncated to p + 1 bits (p significand bits plus guard),
+ *   so the quotient lies r / mb units of the guard bit away from Q: just
+ *   above or below a midpoint when Q is odd, or a representable value when Q
+ *   is even. p < 24 places the result in the subnormal range, where the
+ *   rounding position moves.
+ * - Square root: the RTL takes the integer root R of op = m << 25 (m even for
+ *   odd exponents). op = R^2 + r with small r needs R^2 = -r (mod 2^25 or
+ *   2^26), solved by Hensel lifting; R odd gives near-midpoint roots, R even
+ *   near-representable ones.
+ * - exact_squares(): every positive float whose square root is exact, i.e.
+ *   j^2 * 4^t for odd j < 2^12, normal and subnormal.
+ *
+ * All draws come from a tb::VectorRng, so vectors depend only on
+ * (seed, index).
+ */
+
+#ifndef TB_HARD_CASES_H
+#define TB_HARD_CASES_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "tb_common.h"
+
+namespace tb {
+
+// Largest |r|: results lie at most 2^-19 guard units from the target point
+static constexpr int HARD_DIV_REMAINDER  = 16;
+// r = 8t + 7 for t in [-HARD_SQRT_STEPS, HARD_SQRT_STEPS): roots lie at most
+// |r| / 2^25 <= 2^-17 guard units from a midpoint, 4|r| / 2^25 from a
+// representable root
+static constexpr int HARD_SQRT_STEPS     = 32;
+// Construction attempts per vector before giving up on a draw
+static constexpr int HARD_MAX_ATTEMPTS   = 64;
+
+inline uint32_t hard_fp32_bits(uint32_t sign, uint32_t exp, uint32_t frac) {
+  return (sign & 0x80000000u) | (exp << 23) | (frac & 0x7fffff);
+}
+
+/**
+ * @brief One division operand pair with a hard-to-round quotient
+ * @return false if no solution was found in HARD_MAX_ATTEMPTS draws
+ */
+inline bool hard_div_operands(VectorRng& rng, uint32_t& a_bits, uint32_t& b_bits) {
+  for (int attempt = 0; attempt < HARD_MAX_ATTEMPTS; ++attempt) {
+    // Result precision: normal (24 bits) three times in four, else subnormal
+    int p = rng.below(4) ? 24 : 1 + static_cast<int>(rng.below(23));
+    int k = p + static_cast<int>(rng.next() & 1);  // k = p: ma >= mb, k = p + 1: ma < mb
+    int64_t r = static_cast<int64_t>(rng.below(2 * HARD_DIV_REMAINDER)) - HARD_DIV_REMAINDER;
+    if (r == 0) r = HARD_DIV_REMAINDER;
+    uint64_t mb = 0x800001u | (rng.next() & 0x7ffffe);  // odd: 2 is invertible mod mb
+
+    // ma = r * 2^-k (mod mb)
+    uint64_t inv2 = (mb + 1) / 2;
+    uint64_t c = static_cast<uint64_t>((r % static_cast<int64_t>(mb) + static_cast<int64_t>(mb))) % mb;
+    for (int i = 0; i < k; ++i) c = c * inv2 % mb;
+    uint64_t ma = c;
+    while (ma < 0x800000) ma += mb;
+    if ((ma >= mb) != (k == p)) ma += mb;
+    if (ma > 0xffffff) continue;
+
+    int64_t q = ((static_cast<int64_t>(ma) << k) - r) / static_cast<int64_t>(mb);
+    if (q < (1ll << p) || q >= (1ll << (p + 1))) continue;
+
+    // Unbiased result exponent; subnormal precisions fix it at p - 150
+    int e = p < 24 ? p - 150 : static_cast<int>(rng.below(254)) - 126;
+    int d = e + k - p;  // exp_a - exp_b
+    int lo = d > 0 ? 1 : 1 - d, hi = d > 0 ? 254 - d : 254;
+    if (lo > hi) continue;
+    uint32_t exp_b = lo + rng.below(hi - lo + 1);
+    a_bits = hard_fp32_bits(rng.next(), exp_b + d, static_cast<uint32_t>(ma));
+    b_bits = hard_fp32_bits(rng.next(), exp_b, static_cast<uint32_t>(mb));
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief One positive normal sqrt input whose root is hard to round
+ * @return false if no solution was found in HARD_MAX_ATTEMPTS draws
+ */
+inline bool hard_sqrt_input(VectorRng& rng, uint32_t& a_bits) {
+  for (int attempt = 0; attempt < HARD_MAX_ATTEMPTS; ++attempt) {
+    bool odd_exp = rng.next() & 1;
+    // Guard bit of R: 1 near a midpoint, 0 near a representable root (R = 2R')
+    int half = (rng.next() & 1) ? 0 : 1;
+    int m = (odd_exp ? 26 : 25) - 2 * half;  // low bits of R'^2 that must match
+    int64_t r = 8 * (static_cast<int64_t>(rng.below(2 * HARD_SQRT_STEPS)) - HARD_SQRT_STEPS) + 7;
+    uint64_t mask = (1ull << m) - 1;
+    uint64_t c = static_cast<uint64_t>(-r) & mask;  // R'^2 = c (mod 2^m), c = 1 (mod 8)
+
+    // Hensel lifting: x^2 = c (mod 2^i) gives x or x + 2^(i-1) (mod 2^(i+1))
+    uint64_t x = 1;
+    for (int i = 3; i < m; ++i) {
+      if (((x * x - c) >> i) & 1) x += 1ull << (i - 1);
+    }
+    x &= mask;
+
+    // Roots mod 2^m are +-x and +-x + 2^(m-1); pick one in the R' range
+    uint64_t cands[4] = {x, (0 - x) & mask, (x + (1ull << (m - 1))) & mask, ((0 - x) + (1ull << (m - 1))) & mask};
+    uint64_t lo = 1ull << (24 - half), hi = 1ull << (25 - half);
+    uint64_t root = 0;
+    for (int i = 0, start = rng.below(4); i < 4 && !root; ++i) {
+      uint64_t cand = cands[(start + i) % 4];
+      if (cand >= lo && cand < hi) root = cand;
+    }
+    if (!root) continue;
+
+    uint64_t big_r = root << half;
+    int64_t op = static_cast<int64_t>(big_r * big_r) + (half ? 4 * r : r);
+    if (op < (1ll << (odd_exp ? 49 : 48)) || op >= (1ll << (odd_exp ? 50 : 49))) continue;
+    uint64_t sop = static_cast<uint64_t>(op) >> 25;
+    uint32_t mant = static_cast<uint32_t>(odd_exp ? sop >> 1 : sop);
+
+    // Biased exponent of the requested parity (unbiased odd <=> biased even)
+    uint32_t exp = 1 + 2 * rng.below(127) + (odd_exp ? 1 : 0);
+    a_bits = hard_fp32_bits(0, exp, mant);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Every positive float with an exact square root, in increasing root order per j
+ */
+inline std::vector<uint32_t> exact_squares() {
+  std::vector<uint32_t> out;
+  for (uint32_t j = 1; j < (1u << 12); j += 2) {
+    // j^2 * 4^t: subnormal down to 2^-149 (j^2 is odd), below 2^128 at the top
+    for (int t = -74; t <= 63; ++t) {
+      double x = std::ldexp(static_cast<double>(j) * j, 2 * t);
+      float f = static_cast<float>(x);
+      if (static_cast<double>(f) != x || std::isinf(f)) continue;
+      uint32_t bits;
+      std::memcpy(&bits, &f, sizeof(bits));
+      out.push_back(bits);
+    }
+  }
+  return out;
+}
+
+}  // namespace tb
+
+#endif  // TB_HARD_CASES_H
@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    tb_metamorphic.h
+ * @brief   Metamorphic variants: more DUT vectors per reference result
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Exact identities derive the expected result of a transformed vector from
+ * the reference result of the original, so one reference call checks
+ * several DUT evaluations:
+ *
+ * - Division: -a / b = a / -b = -(a / b), with the same flags (not for NaN
+ *   results, whose sign is implementation-defined).
+ * - Division: (a * 2^k) / b = (a / b) * 2^k and a / (b * 2^k) = (a / b) * 2^-k
+ *   while the scaled operand is exact and both results keep a biased
+ *   exponent in [2, 253], so neither side can overflow or underflow and the
+ *   flags (inexact only) carry over.
+ * - Square root: sqrt(x * 4^k) = sqrt(x) * 2^k for positive finite x with
+ *   x * 4^k exact and finite; square roots never overflow or underflow, so
+ *   the flags carry over.
+ *
+ * A transform that does not apply to a vector falls back to a sign flip
+ * (division) or yields no variant (square root).
+ */
+
+#ifndef TB_METAMORPHIC_H
+#define TB_METAMORPHIC_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "fp32_ref_model.h"
+#include "tb_common.h"
+
+namespace tb {
+
+/**
+ * @brief One transformed vector and its expected result
+ */
+struct Variant {
+  uint32_t a, b;               // Operands (b unused for square root)
+  fp32_ref::Result expected;
+  const char* transform;       // Identity used, for failure reports
+};
+
+inline float variant_float(uint32_t bits) {
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+inline uint32_t variant_bits(float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+/**
+ * @brief Scale a finite nonzero value by 2^k, if that is exact and stays finite and nonzero
+ */
+inline bool scale_exact(uint32_t x, int k, uint32_t& out) {
+  float f = variant_float(x);
+  if (!std::isfinite(f) || f == 0.0f) return false;
+  float g = std::ldexp(f, k);
+  if (!std::isfinite(g) || g == 0.0f || std::ldexp(g, -k) != f) return false;
+  out = variant_bits(g);
+  return true;
+}
+
+/**
+ * @brief A division variant of (a, b) with reference result `ref`
+ * @return false if the quotient is NaN (no identity applies)
+ */
+inline bool div_variant(VectorRng& rng, uint32_t a, uint32_t b, const fp32_ref::Result& ref, Variant& v) {
+  if (std::isnan(variant_float(ref.y))) return false;
+  uint32_t pick = rng.below(4);
+  int ey = (ref.y >> 23) & 0xff;
+  if (pick >= 2 && ey >= 2 && ey <= 253) {
+    // Result exponent stays in [2, 253]; the scaled operand must be exact
+    int k_lo = 2 - ey, k_hi = 253 - ey;
+    int k = k_lo + static_cast<int>(rng.below(k_hi - k_lo + 1));
+    uint32_t scaled;
+    if (k != 0 && scale_exact(pick == 2 ? a : b, pick == 2 ? k : -k, scaled)) {
+      v.a = pick == 2 ? scaled : a;
+      v.b = pick == 2 ? b : scaled;
+      v.expected.y = (ref.y & 0x807fffff) | static_cast<uint32_t>(ey + k) << 23;
+      v.expected.flags = ref.flags;
+      v.transform = pick == 2 ? "a*2^k" : "b*2^-k";
+      return true;
+    }
+  }
+  bool flip_a = pick % 2 == 0;
+  v.a = flip_a ? a ^ 0x80000000u : a;
+  v.b = flip_a ? b : b ^ 0x80000000u;
+  v.expected.y = ref.y ^ 0x80000000u;
+  v.expected.flags = ref.flags;
+  v.transform = flip_a ? "-a" : "-b";
+  return true;
+}
+
+/**
+ * @brief A square root variant of `a` with reference result `ref`
+ * @return false unless `a` is positive, finite and nonzero
+ */
+inline bool sqrt_variant(VectorRng& rng, uint32_t a, const fp32_ref::Result& ref, Variant& v) {
+  float x = variant_float(a);
+  if (!(x > 0.0f) || !std::isfinite(x)) return false;
+  // k with x * 4^k in the normal or subnormal range: |x| spans [2^-149, 2^128)
+  int e = std::ilogb(x);
+  int k_lo = -((e + 149) / 2), k_hi = (127 - e) / 2;
+  for (int attempt = 0; attempt < 4; ++attempt) {
+    int k = k_lo + static_cast<int>(rng.below(k_hi - k_lo + 1));
+    uint32_t scaled;
+    if (k == 0 || !scale_exact(a, 2 * k, scaled)) continue;
+    v.a = scaled;
+    v.b = 0;
+    v.expected.y = variant_bits(std::ldexp(variant_float(ref.y), k));
+    v.expected.flags = ref.flags;
+    v.transform = "a*4^k";
+    return true;
+  }
+  return false;
+}
+
+}  // namespace tb
+
+#endif  // TB_METAMORPHIC_H
@@ -0,0 +1,189 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    tb_mismatch.h
+ * @brief   Mismatch classes for --keep-going runs
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * With --keep-going the testbenches do not stop at the first mismatch.
+ * Every mismatch is put into a class keyed by operand classes, datapath,
+ * ULP distance bucket and the flag bits that differ, so independent defects
+ * show up as separate classes in one run. Each class keeps a count and its
+ * first MAX_EXAMPLES vectors; only those go to the failure corpus, and only
+ * the first MAX_REPORTS mismatches print a full report, so a defect hit by
+ * millions of vectors stays readable.
+ *
+ * Workers of the random phase share one instance; mismatches are rare, so
+ * a mutex around add() costs nothing in the hot loop.
+ */
+
+#ifndef TB_MISMATCH_H
+#define TB_MISMATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "tb_common.h"
+
+namespace tb {
+
+/**
+ * @brief Mismatch classes with counts and representative vectors
+ */
+class MismatchClusters {
+public:
+  static constexpr size_t   MAX_EXAMPLES = 3;   // Representative vectors kept per class
+  static constexpr uint64_t MAX_REPORTS = 50;   // Full mismatch reports printed per run
+
+  /**
+   * @brief One mismatching vector
+   */
+  struct Vector {
+    std::vector<uint32_t> operands;
+    uint32_t expected, actual;
+    unsigned expected_flags, actual_flags;
+    std::string origin;  // Phase, plus the replay arguments of random vectors
+  };
+
+  /**
+   * @brief Class key of vector `v` evaluated on datapath `path`
+   *
+   * A vector the DUT gets right has "ulp=0 flags=ok", which no mismatch has.
+   */
+  static std::string classify(const std::string& path, const Vector& v) {
+    std::string key = "ops=";
+    for (size_t i = 0; i < v.operands.size(); ++i) key += std::string(i ? "/" : "") + operand_class(v.operands[i]);
+    return key + " path=" + path + " ulp=" + ulp_bucket(v.expected, v.actual) +
+           " flags=" + flag_diff(v.expected_flags, v.actual_flags);
+  }
+
+  /**
+   * @brief Add a mismatch of datapath `path`
+   * @return true if it was kept as a representative of its class
+   */
+  bool add(const std::string& path, const Vector& v) {
+    std::string key = classify(path, v);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Class& c = classes_[key];
+    ++c.count;
+    ++total_;
+    if (c.examples.size() >= MAX_EXAMPLES) return false;
+    for (const auto& e : c.examples) {
+      if (e.operands == v.operands) return false;
+    }
+    c.examples.push_back(v);
+    return true;
+  }
+
+  /**
+   * @brief Whether the caller may print a full report for one more mismatch
+   */
+  bool claim_report() {
+    uint64_t n = reports_.fetch_add(1, std::memory_order_relaxed);
+    if (n == MAX_REPORTS) {
+      std::lock_guard<std::mutex> lock(output_mutex());
+      std::cout << "(further mismatch reports suppressed; see the mismatch class summary)" << std::endl;
+    }
+    return n < MAX_REPORTS;
+  }
+
+  uint64_t total() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_;
+  }
+
+  /**
+   * @brief Print the classes, most frequent first, with their representatives
+   */
+  void report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::string, const Class*>> sorted;
+    for (const auto& kv : classes_) sorted.push_back({kv.first, &kv.second});
+    std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, const Class*>& x,
+                                                      const std::pair<std::string, const Class*>& y) {
+      return x.second->count > y.second->count;
+    });
+
+    std::cout << "\n=== Mismatch classes ===" << std::endl;
+    std::cout << "Mismatches: " << total_ << " in " << classes_.size() << " classes" << std::endl;
+    for (const auto& entry : sorted) {
+      std::cout << "  " << entry.second->count << "x " << entry.first << std::endl;
+      for (const auto& v : entry.second->examples) {
+        std::printf("    ");
+        for (uint32_t op : v.operands) std::printf("0x%08x ", op);
+        std::printf("expected 0x%08x/0x%02x actual 0x%08x/0x%02x  %s\n", v.expected, v.expected_flags, v.actual,
+                    v.actual_flags, v.origin.c_str());
+      }
+    }
+    std::fflush(stdout);
+  }
+
+private:
+  struct Class {
+    uint64_t count = 0;
+    std::vector<Vector> examples;
+  };
+
+  // Operand signs only flip the result sign, so they do not split classes
+  static const char* operand_class(uint32_t x) {
+    uint32_t exp = (x >> 23) & 0xff, frac = x & 0x7fffff;
+    if (exp == 0xff) return frac ? "nan" : "inf";
+    if (exp == 0) return frac ? "subnormal" : "zero";
+    return "normal";
+  }
+
+  static std::string ulp_bucket(uint32_t expected, uint32_t actual) {
+    bool nan_e = (expected & 0x7fffffff) > 0x7f800000, nan_a = (actual & 0x7fffffff) > 0x7f800000;
+    if (nan_e || nan_a) return nan_e && nan_a ? (expected == actual ? "0" : "nan_payload") : "nan";
+    if ((expected ^ actual) & 0x80000000) return "sign";  // includes +0 vs -0
+    uint32_t d = expected > actual ? expected - actual : actual - expected;
+    if (d <= 1) return d ? "1" : "0";
+    if (d < 16) return "2-15";
+    if (d < 256) return "16-255";
+    return "256+";
+  }
+
+  // "+name" for flags only the DUT raised, "-name" for flags it missed
+  static std::string flag_diff(unsigned expected, unsigned actual) {
+    static const char* const names[] = {"inexact", "underflow", "overflow", "divzero", "invalid"};
+    std::string text;
+    for (int bit = 4; bit >= 0; --bit) {
+      unsigned e = (expected >> bit) & 1, a = (actual >> bit) & 1;
+      if (e == a) continue;
+      if (!text.empty()) text += ',';
+      text += (a ? "+" : "-") + std::string(names[bit]);
+    }
+    return text.empty() ? "ok" : text;
+  }
+
+  mutable std::mutex             mutex_;
+  std::map<std::string, Class>   classes_;
+  uint64_t                       total_ = 0;
+  std::atomic<uint64_t>          reports_{0};
+};
+
+}  // namespace tb
+
+#endif  // TB_MISMATCH_H
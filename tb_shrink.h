@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 adachi6k
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**
+ * @file    tb_shrink.h
+ * @brief   Delta-debugging minimizer for failing operand vectors
+ * @author  adachi6k
+ * @date    2025
+ *
+ * @description
+ * Failing random vectors come with arbitrary bit patterns. shrink_operands()
+ * tries ever simpler operands and keeps a change only while the caller's
+ * predicate still holds; the testbenches pass "the DUT still mismatches
+ * SoftFloat with the same mismatch class" (tb::MismatchClusters::classify).
+ * Each pass, in order:
+ *
+ * - clears sign bits;
+ * - moves biased exponents toward the bias (127): all operands by the same
+ *   step first, which keeps the exponent difference a division result
+ *   depends on, then each operand alone; a rejected step is halved;
+ * - clears significand bits by delta debugging: all set bits at once, then
+ *   halves, quarters, ... down to single bits.
+ *
+ * Zero, subnormal, infinite and NaN operands keep their exponent field.
+ * Passes repeat until one changes nothing or SHRINK_MAX_EVALS predicate
+ * calls are spent, so the result is a local minimum: no single step above
+ * simplifies it further.
+ */
+
+#ifndef TB_SHRINK_H
+#define TB_SHRINK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace tb {
+
+// Predicate calls per minimization (each is one DUT eval and one reference call)
+static constexpr unsigned SHRINK_MAX_EVALS = 4096;
+static constexpr int      SHRINK_BIAS      = 127;
+
+inline int shrink_exp(uint32_t x) { return (x >> 23) & 0xff; }
+
+/**
+ * @brief Move the exponent of operand `which` (all operands if which == ops.size()) toward the bias
+ */
+template <typename Attempt>
+inline bool shrink_exponent(std::vector<uint32_t>& ops, size_t which, Attempt& attempt) {
+  bool all = which == ops.size();
+  for (size_t i = 0; i < ops.size(); ++i) {
+    int e = shrink_exp(ops[i]);
+    if ((all || i == which) && (e == 0 || e == 255)) return false;
+  }
+  bool changed = false;
+  for (;;) {
+    // Steps from the distance of the first moved operand, halved on rejection
+    int dist = SHRINK_BIAS - shrink_exp(ops[all ? 0 : which]);
+    bool moved = false;
+    for (int step = dist; step != 0 && !moved; step /= 2) {
+      std::vector<uint32_t> cand = ops;
+      bool valid = true;
+      for (size_t i = 0; i < ops.size(); ++i) {
+        if (!all && i != which) continue;
+        int e = shrink_exp(ops[i]) + step;
+        if (e < 1 || e > 254) valid = false;
+        cand[i] = (ops[i] & 0x807fffffu) | static_cast<uint32_t>(e) << 23;
+      }
+      moved = valid && attempt(cand);
+    }
+    if (!moved) return changed;
+    changed = true;
+  }
+}
+
+/**
+ * @brief Clear significand bits of operand `i` by delta debugging
+ */
+template <typename Attempt>
+inline bool shrink_mantissa(std::vector<uint32_t>& ops, size_t i, Attempt& attempt) {
+  bool changed = false;
+  size_t chunks = 1;
+  for (;;) {
+    std::vector<uint32_t> bits;
+    for (int b = 22; b >= 0; --b) {
+      if ((ops[i] >> b) & 1) bits.push_back(1u << b);
+    }
+    if (bits.empty()) return changed;
+    chunks = std::min(chunks, bits.size());
+    bool removed = false;
+    for (size_t c = 0; c < chunks && !removed; ++c) {
+      uint32_t mask = 0;
+      for (size_t k = c * bits.size() / chunks; k < (c + 1) * bits.size() / chunks; ++k) mask |= bits[k];
+      std::vector<uint32_t> cand = ops;
+      cand[i] &= ~mask;
+      removed = attempt(cand);
+    }
+    if (removed) {
+      changed = true;
+      chunks = std::max<size_t>(chunks - 1, 1);
+    } else if (chunks == bits.size()) {
+      return changed;
+    } else {
+      chunks *= 2;
+    }
+  }
+}
+
+/**
+ * @brief Simplify `ops` while still_fails(candidate) holds
+ * @return Number of still_fails() calls made
+ */
+template <typename StillFails>
+inline unsigned shrink_operands(std::vector<uint32_t>& ops, StillFails still_fails) {
+  unsigned evals = 0;
+  auto attempt = [&](const std::vector<uint32_t>& cand) {
+    if (cand == ops || evals >= SHRINK_MAX_EVALS) return false;
+    ++evals;
+    if (!still_fails(cand)) return false;
+    ops = cand;
+    return true;
+  };
+  bool progress = true;
+  while (progress && evals < SHRINK_MAX_EVALS) {
+    progress = false;
+    for (size_t i = 0; i < ops.size(); ++i) {
+      if (!(ops[i] & 0x80000000u)) continue;
+      std::vector<uint32_t> cand = ops;
+      cand[i] &= 0x7fffffffu;
+      progress |= attempt(cand);
+    }
+    if (ops.size() > 1) progress |= shrink_exponent(ops, ops.size(), attempt);
+    for (size_t i = 0; i < ops.size(); ++i) progress |= shrink_exponent(ops, i, attempt);
+    for (size_t i = 0; i < ops.size(); ++i) progress |= shrink_mantissa(ops, i, attempt);
+  }
+  return evals;
+}
+
+}  // namespace tb
+
+#endif  // TB_SHRINK_H